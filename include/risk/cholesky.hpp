@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include <risk/linalg.hpp>
+
+namespace risk {
+
+namespace linalg {
+
+// Lower Cholesky factor L (A = L L^T) of a symmetric positive definite matrix,
+// of which only the lower triangle is read. Right-looking and blocked: each
+// panel of columns is factored, then the trailing matrix takes one rank-k update
+// through gemm, split by row blocks over `threads` workers (0: one per hardware
+// thread). The result does not depend on the thread count. Throws
+// std::invalid_argument if a is not square or a pivot is not positive.
+Matrix cholesky(const Matrix& a, std::size_t threads = 1);
+
+// Cholesky factorization with symmetric pivoting (LAPACK dpstrf) for positive
+// semi-definite matrices such as sample covariances of short histories:
+// P^T A P = L L^T, eliminating the largest remaining diagonal first and
+// stopping once it falls to the tolerance.
+struct PivotedCholesky {
+    Matrix factor;                    // n × rank, rows in the order of A: factor factor^T = A
+    std::vector<std::size_t> pivots;  // pivots[j]: row of A eliminated at step j
+    std::size_t rank = 0;
+    // First over last kept pivot, L_00^2 / L_rr^2: a lower bound on the 2-norm
+    // condition number of the rank-r part of A. Zero when the rank is zero.
+    double condition = 0.0;
+};
+
+// Same blocking and threading as cholesky. A negative tolerance selects
+// n * eps * max diagonal. Throws std::invalid_argument if a is not square or the
+// part left unfactored is not negligible, i.e. a is not positive semi-definite.
+PivotedCholesky pivoted_cholesky(const Matrix& a, double tolerance = -1.0, std::size_t threads = 1);
+
+// Rank-one modifications of a lower Cholesky factor in O(n^2), instead of the
+// O(n^3) refactorization: afterwards l l^T equals the old l l^T plus (update)
+// or minus (downdate) x x^T. Both sweep l row by row, applying the Givens
+// (hyperbolic, for the downdate) rotations of the rows above. Throw
+// std::invalid_argument if l is not square, x has the wrong length, or l has a
+// non-positive diagonal.
+void cholesky_update(Matrix& l, std::span<const double> x);
+
+// Returns false, leaving l unchanged, if the downdated matrix would not be
+// positive definite to working precision (a pivot would lose all but n eps of
+// its square).
+bool cholesky_downdate(Matrix& l, std::span<const double> x);
+
+} // namespace linalg
+
+} // namespace risk
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <span>
+#include <vector>
+
+#include <risk/aligned.hpp>
+#include <risk/instrument_soa.hpp>
+#include <risk/revaluation.hpp>
+
+namespace risk {
+
+// Second-order Taylor expansion of portfolio P&L in the factor shocks, built
+// from compute_greeks:
+//   pnl(x) = sum_f x_f * (linear_f + quadratic_f * x_f)
+// with linear_f the dollar delta (qty * delta * S) and quadratic_f half the
+// dollar gamma (qty * gamma * S^2 / 2) of all positions on factor f. Equity
+// lines are linear, so the expansion is exact for them. Scenarios only shock
+// spots, so there is no vega term.
+class DeltaGammaModel {
+public:
+    DeltaGammaModel() = default;
+
+    // Throws std::out_of_range if any id or underlying_index is >= factor_count.
+    DeltaGammaModel(const InstrumentSoA& soa, std::size_t factor_count);
+
+    [[nodiscard]] std::size_t factor_count() const noexcept { return linear_.size(); }
+    [[nodiscard]] const AlignedVector<double>& linear() const noexcept { return linear_; }
+    [[nodiscard]] const AlignedVector<double>& quadratic() const noexcept { return quadratic_; }
+
+    [[nodiscard]] double pnl(const double* shocks_row) const;
+
+    // pnl() for each row of a row-major rows × factor_count() shock matrix.
+    void pnl(std::span<const double> shocks_flat, std::size_t rows, std::span<double> out) const;
+
+private:
+    AlignedVector<double> linear_;
+    AlignedVector<double> quadratic_;
+};
+
+// Reprices rows (ascending scenario indices) in full, writing out[i] for rows[i].
+using RepriceRows = std::function<void(std::span<const std::size_t> rows, std::span<double> out)>;
+
+// Hybrid revaluation. pnls holds approximate P&L on entry, and full P&L lies in
+// [lower[t], upper[t]] (see PnlBounds). The scenarios with the lowest
+// approximations are repriced in full first, which pins the (k + 1)-th smallest
+// upper bound, with k = floor(q * (n - 1)), close to the true quantile; then
+// every scenario whose lower bound does not exceed it is repriced too. Returns
+// the repriced scenarios in ascending order, with their full P&L in pnls. As in
+// tail_candidates, they include every scenario at or below the q-quantile of
+// full P&L, so VaR and ES over them equal full revaluation.
+std::vector<std::size_t> refine_tail(std::vector<double>& pnls,
+                                     std::span<const double> lower,
+                                     std::span<const double> upper,
+                                     double q,
+                                     const RepriceRows& reprice,
+                                     RevaluationStats& stats);
+
+} // namespace risk
@@ -1,78 +1,270 @@
 #pragma once
 
+#include <cassert>
 #include <cstddef>
-#include <vector>
+#include <span>
+#include <utility>
 
+#include <risk/aligned.hpp>
+#include <risk/linalg.hpp>
+
+// Stand-in for the few Eigen dense types the engine uses, on the engine's own
+// storage: 64-byte aligned and row-major, with unchecked element access
+// (asserted in debug builds). Vectors and matrix rows are spans, and a matrix
+// shares its storage with the linalg kernels: matrix() views it as a
+// risk::linalg::Matrix, which can also be moved in and out without a copy.
+// Map<VectorXd> and Map<MatrixXd> (or their const forms) view storage the
+// engine does not own, such as a cache mapping, and col() views a column in
+// place with a stride.
 namespace Eigen {
 
 using Index = std::ptrdiff_t;
 
+// Non-owning view of size() elements stride() apart. Scalar is double or
+// const double.
+template <class Scalar>
+class StridedVector {
+public:
+    StridedVector(Scalar* data, Index size, Index stride) noexcept : data_(data), size_(size), stride_(stride) {
+        assert(size >= 0 && stride >= 1);
+    }
+
+    Index size() const noexcept {
+        return size_;
+    }
+
+    Index stride() const noexcept {
+        return stride_;
+    }
+
+    Scalar& operator()(Index idx) const noexcept {
+        assert(idx >= 0 && idx < size_);
+        return data_[idx * stride_];
+    }
+
+    Scalar* data() const noexcept {
+        return data_;
+    }
+
+private:
+    Scalar* data_ = nullptr;
+    Index size_ = 0;
+    Index stride_ = 1;
+};
+
+// Non-owning contiguous vector over a span.
+template <class Scalar>
+class VectorMap {
+public:
+    explicit VectorMap(std::span<Scalar> values) noexcept : values_(values) {}
+
+    Index size() const noexcept {
+        return static_cast<Index>(values_.size());
+    }
+
+    Scalar& operator()(Index idx) const noexcept {
+        assert(idx >= 0 && idx < size());
+        return values_[static_cast<std::size_t>(idx)];
+    }
+
+    Scalar* data() const noexcept {
+        return values_.data();
+    }
+
+    std::span<Scalar> values() const noexcept {
+        return values_;
+    }
+
+private:
+    std::span<Scalar> values_;
+};
+
+// Non-owning row-major rows × cols matrix over a span of rows * cols values.
+template <class Scalar>
+class MatrixMap {
+public:
+    MatrixMap(std::span<Scalar> values, Index rows, Index cols) noexcept
+        : values_(values), rows_(rows), cols_(cols) {
+        assert(rows >= 0 && cols >= 0 && values.size() == static_cast<std::size_t>(rows * cols));
+    }
+
+    Index rows() const noexcept {
+        return rows_;
+    }
+
+    Index cols() const noexcept {
+        return cols_;
+    }
+
+    Scalar& operator()(Index row, Index col) const noexcept {
+        assert(row >= 0 && row < rows_ && col >= 0 && col < cols_);
+        return values_[static_cast<std::size_t>(row * cols_ + col)];
+    }
+
+    std::span<Scalar> row(Index r) const noexcept {
+        assert(r >= 0 && r < rows_);
+        return values_.subspan(static_cast<std::size_t>(r * cols_), static_cast<std::size_t>(cols_));
+    }
+
+    StridedVector<Scalar> col(Index c) const noexcept {
+        assert(c >= 0 && c < cols_);
+        return {values_.data() + c, rows_, cols_ > 0 ? cols_ : 1};
+    }
+
+    std::span<Scalar> values() const noexcept {
+        return values_;
+    }
+
+private:
+    std::span<Scalar> values_;
+    Index rows_ = 0;
+    Index cols_ = 0;
+};
+
+class VectorXd;
+class MatrixXd;
+
+namespace detail {
+
+template <class Plain>
+struct MapOf;
+
+template <>
+struct MapOf<VectorXd> {
+    using type = VectorMap<double>;
+};
+
+template <>
+struct MapOf<const VectorXd> {
+    using type = VectorMap<const double>;
+};
+
+template <>
+struct MapOf<MatrixXd> {
+    using type = MatrixMap<double>;
+};
+
+template <>
+struct MapOf<const MatrixXd> {
+    using type = MatrixMap<const double>;
+};
+
+} // namespace detail
+
+// Eigen's spelling: Map<const VectorXd> v(span), Map<MatrixXd> m(span, rows, cols).
+template <class Plain>
+using Map = typename detail::MapOf<Plain>::type;
+
 class VectorXd {
 public:
     VectorXd() = default;
-    explicit VectorXd(Index n)
-        : data_(static_cast<std::size_t>(n), 0.0) {}
+    explicit VectorXd(Index n) : data_(static_cast<std::size_t>(n), 0.0) {}
+    // Copies; Map<const VectorXd> views values in place.
+    explicit VectorXd(std::span<const double> values) : data_(values.begin(), values.end()) {}
 
     static VectorXd Zero(Index n) {
         return VectorXd(n);
     }
 
-    Index size() const {
+    Index size() const noexcept {
         return static_cast<Index>(data_.size());
     }
 
-    double& operator()(Index idx) {
-        return data_.at(static_cast<std::size_t>(idx));
+    double& operator()(Index idx) noexcept {
+        assert(idx >= 0 && idx < size());
+        return data_[static_cast<std::size_t>(idx)];
     }
 
-    double operator()(Index idx) const {
-        return data_.at(static_cast<std::size_t>(idx));
+    double operator()(Index idx) const noexcept {
+        assert(idx >= 0 && idx < size());
+        return data_[static_cast<std::size_t>(idx)];
     }
 
-    const double* data() const {
+    double* data() noexcept {
         return data_.data();
     }
 
+    const double* data() const noexcept {
+        return data_.data();
+    }
+
+    std::span<double> values() noexcept {
+        return data_;
+    }
+
+    std::span<const double> values() const noexcept {
+        return data_;
+    }
+
 private:
-    std::vector<double> data_{};
+    risk::AlignedVector<double> data_{};
 };
 
 class MatrixXd {
 public:
     MatrixXd() = default;
-    MatrixXd(Index rows, Index cols)
-        : rows_(rows), cols_(cols), data_(static_cast<std::size_t>(rows) * static_cast<std::size_t>(cols), 0.0) {}
+    MatrixXd(Index rows, Index cols) : matrix_(static_cast<std::size_t>(rows), static_cast<std::size_t>(cols)) {}
+    explicit MatrixXd(risk::linalg::Matrix&& matrix) noexcept : matrix_(std::move(matrix)) {}
 
     static MatrixXd Zero(Index rows, Index cols) {
         return MatrixXd(rows, cols);
     }
 
-    Index rows() const {
-        return rows_;
+    Index rows() const noexcept {
+        return static_cast<Index>(matrix_.rows());
     }
 
-    Index cols() const {
-        return cols_;
+    Index cols() const noexcept {
+        return static_cast<Index>(matrix_.cols());
     }
 
-    double& operator()(Index row, Index col) {
-        return data_.at(linear_index(row, col));
+    double& operator()(Index row, Index col) noexcept {
+        assert(row >= 0 && row < rows() && col >= 0 && col < cols());
+        return matrix_(static_cast<std::size_t>(row), static_cast<std::size_t>(col));
     }
 
-    double operator()(Index row, Index col) const {
-        return data_.at(linear_index(row, col));
+    double operator()(Index row, Index col) const noexcept {
+        assert(row >= 0 && row < rows() && col >= 0 && col < cols());
+        return matrix_(static_cast<std::size_t>(row), static_cast<std::size_t>(col));
     }
 
-private:
-    Index rows_ = 0;
-    Index cols_ = 0;
-    std::vector<double> data_{};
+    std::span<double> row(Index r) noexcept {
+        assert(r >= 0 && r < rows());
+        return matrix_.row(static_cast<std::size_t>(r));
+    }
+
+    std::span<const double> row(Index r) const noexcept {
+        assert(r >= 0 && r < rows());
+        return matrix_.row(static_cast<std::size_t>(r));
+    }
+
+    StridedVector<double> col(Index c) noexcept {
+        return Map<MatrixXd>(values(), rows(), cols()).col(c);
+    }
 
-    std::size_t linear_index(Index row, Index col) const {
-        return static_cast<std::size_t>(row) * static_cast<std::size_t>(cols_) +
-               static_cast<std::size_t>(col);
+    StridedVector<const double> col(Index c) const noexcept {
+        return Map<const MatrixXd>(values(), rows(), cols()).col(c);
     }
+
+    // Row-major: element (r, c) at r * cols() + c.
+    std::span<double> values() noexcept {
+        return matrix_.values();
+    }
+
+    std::span<const double> values() const noexcept {
+        return matrix_.values();
+    }
+
+    const risk::linalg::Matrix& matrix() const& noexcept {
+        return matrix_;
+    }
+
+    risk::linalg::Matrix matrix() && noexcept {
+        return std::move(matrix_);
+    }
+
+private:
+    risk::linalg::Matrix matrix_{};
 };
 
 } // namespace Eigen
-
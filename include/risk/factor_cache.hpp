@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <risk/mapped_file.hpp>
+
+namespace risk {
+
+// 128-bit content hash naming a cache entry.
+struct CacheKey {
+    std::uint64_t hi = 0;
+    std::uint64_t lo = 0;
+
+    [[nodiscard]] std::string hex() const;
+    friend bool operator==(const CacheKey&, const CacheKey&) = default;
+};
+
+// Hashes everything an entry depends on, in order. Two lanes of
+// multiply-rotate mixing over 64-bit words: fast, not cryptographic.
+class CacheKeyBuilder {
+public:
+    CacheKeyBuilder& add(std::string_view text);
+    CacheKeyBuilder& add(std::uint64_t value);
+    CacheKeyBuilder& add(double value);
+    CacheKeyBuilder& add(std::span<const double> values);
+
+    [[nodiscard]] CacheKey key() const;
+
+private:
+    void mix(std::uint64_t word) noexcept;
+
+    std::uint64_t a_ = 0x6A09E667F3BCC908ULL;
+    std::uint64_t b_ = 0xBB67AE8584CAA73BULL;
+    std::uint64_t words_ = 0;
+};
+
+// A dense row-major array of doubles stored in an entry.
+struct CacheArray {
+    std::size_t rows = 0;
+    std::size_t cols = 0;
+    std::span<const double> values;
+};
+
+// A validated entry, mapped read-only; its arrays are views into the mapping.
+class CacheEntry {
+public:
+    [[nodiscard]] std::size_t size() const noexcept { return arrays_.size(); }
+    [[nodiscard]] const CacheArray& array(std::size_t i) const { return arrays_.at(i); }
+
+private:
+    friend class FactorCache;
+
+    MappedFile file_;
+    std::vector<CacheArray> arrays_;
+};
+
+// How much of an entry load() verifies. Header checks the magic, version, key,
+// file size and a checksum of the array shapes, touching only the first page:
+// entries are renamed into place whole, so a torn write cannot be seen. Full
+// also checksums the payload, which reads every page of the mapping.
+enum class CacheCheck : std::uint8_t { Header = 0, Full = 1 };
+
+// Content-addressed directory of cached arrays (sample moments, covariance
+// factors), one file per key: <directory>/<key hex>.rfc. A file is a 64-byte
+// header (magic, format version, key, checksums, size), the array shapes, then
+// each array at a 64-byte aligned offset, in native byte order, so an entry is
+// used straight from its mapping.
+//
+// With a size limit, every store evicts least recently used entries (by
+// modification time, which load() refreshes) until the directory's entries fit.
+class FactorCache {
+public:
+    // max_bytes: total size of the entries to keep (0: unlimited).
+    explicit FactorCache(std::string directory, std::uintmax_t max_bytes = 0);
+
+    [[nodiscard]] const std::string& directory() const noexcept { return directory_; }
+    [[nodiscard]] std::uintmax_t max_bytes() const noexcept { return max_bytes_; }
+
+    // The entry for key, or nullopt if there is none or it fails validation at
+    // the given level. A bad entry is replaced by the next store.
+    [[nodiscard]] std::optional<CacheEntry> load(const CacheKey& key, CacheCheck check = CacheCheck::Header) const;
+
+    // Writes the entry to a temporary file and renames it into place, so readers
+    // never see a partial entry; creates the directory if needed, then evicts
+    // down to max_bytes. Returns false if the entry could not be written.
+    bool store(const CacheKey& key, std::span<const CacheArray> arrays) const;
+
+private:
+    [[nodiscard]] std::string entry_path(const CacheKey& key) const;
+    void evict(const std::string& keep) const;
+
+    std::string directory_;
+    std::uintmax_t max_bytes_ = 0;
+};
+
+} // namespace risk
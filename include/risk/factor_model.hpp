@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+
+#include <risk/aligned.hpp>
+#include <risk/linalg.hpp>
+
+namespace risk {
+
+// Principal-component factor model of a covariance matrix:
+//   Sigma ~ B B^T + diag(s^2)
+// where column j of B is the j-th eigenvector scaled by the square root of its
+// eigenvalue, and s^2 is whatever diagonal variance the kept components leave
+// unexplained, so every variance is matched exactly. A draw costs k + n normals
+// and O(n k) work instead of the O(n^2) of a full Cholesky factor.
+struct FactorModel {
+    linalg::Matrix loadings_t;        // k × n: B^T
+    AlignedVector<double> specific;   // n: idiosyncratic standard deviations s
+    double explained_variance = 0.0;  // kept eigenvalues over the trace
+};
+
+// The top `factors` principal components of a symmetric covariance matrix.
+// Eigenvalues below zero (round-off in a PSD matrix) count as zero. Throws
+// std::invalid_argument if cov is not square or factors is zero or exceeds its
+// order.
+FactorModel pca_factor_model(const linalg::Matrix& cov, std::size_t factors);
+
+} // namespace risk
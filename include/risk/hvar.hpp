@@ -4,20 +4,23 @@
 #include <vector>
 
 #include <risk/instrument_soa.hpp>
+#include <risk/revaluation.hpp>
 
 namespace risk {
 
-struct RiskMetrics {
-    double var = 0.0;
-    double cvar = 0.0;
-};
-
+// One-off revaluation. Scenario loops should build a PreparedPortfolio once and
+// call revalue() instead.
 double hvarday(const InstrumentSoA& soa, const double* shocks_row);
 
+// In grid mode the option ladders span the min/max shock of each underlying in
+// shocks_flat, so every scenario is covered. stats, if given, receives the grid
+// or hybrid diagnostics.
 RiskMetrics compute_hvar(const InstrumentSoA& soa,
                          const std::vector<double>& shocks_flat,
                          std::size_t Tm1,
                          std::size_t N,
-                         double alpha);
+                         double alpha,
+                         const RevaluationOptions& revaluation = {},
+                         RevaluationStats* stats = nullptr);
 
 } // namespace risk
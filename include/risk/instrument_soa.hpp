@@ -28,4 +28,19 @@ struct InstrumentSoA {
 
 InstrumentSoA to_struct_of_arrays(const std::vector<Instrument>& instruments);
 
+// Appends row `index` of src to dst, column by column.
+void append_instrument(InstrumentSoA& dst, const InstrumentSoA& src, std::size_t index);
+
+// The shock factors a portfolio references: equity ids and option underlying
+// indices, ascending. soa is the portfolio with each of those indices replaced
+// by its position in factors, so it revalues against rows of factors.size()
+// shocks.
+struct FactorSubset {
+    std::vector<std::uint32_t> factors;
+    InstrumentSoA soa;
+};
+
+// Throws std::out_of_range if any referenced index is >= factor_count.
+FactorSubset referenced_factors(const InstrumentSoA& soa, std::size_t factor_count);
+
 } // namespace risk
@@ -0,0 +1,92 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+#include <risk/aligned.hpp>
+
+namespace risk {
+
+namespace linalg {
+
+// Dense kernels over row-major storage. Reductions keep a fixed set of lane-wise
+// partial sums, so they vectorize without -ffast-math and give the same result
+// on every run.
+
+double dot(std::span<const double> x, std::span<const double> y);
+
+// y = A x for a row-major rows × cols matrix A.
+void gemv(std::span<const double> a,
+          std::size_t rows,
+          std::size_t cols,
+          std::span<const double> x,
+          std::span<double> y);
+
+// Dense row-major matrix on cache-line aligned storage.
+class Matrix {
+public:
+    Matrix() = default;
+    Matrix(std::size_t rows, std::size_t cols) : rows_(rows), cols_(cols), data_(rows * cols, 0.0) {}
+
+    [[nodiscard]] std::size_t rows() const noexcept { return rows_; }
+    [[nodiscard]] std::size_t cols() const noexcept { return cols_; }
+
+    double& operator()(std::size_t r, std::size_t c) noexcept { return data_[r * cols_ + c]; }
+    double operator()(std::size_t r, std::size_t c) const noexcept { return data_[r * cols_ + c]; }
+
+    [[nodiscard]] std::span<double> row(std::size_t r) noexcept { return {data_.data() + r * cols_, cols_}; }
+    [[nodiscard]] std::span<const double> row(std::size_t r) const noexcept { return {data_.data() + r * cols_, cols_}; }
+
+    [[nodiscard]] std::span<double> values() noexcept { return data_; }
+    [[nodiscard]] std::span<const double> values() const noexcept { return data_; }
+
+    [[nodiscard]] Matrix transposed() const;
+
+private:
+    std::size_t rows_ = 0;
+    std::size_t cols_ = 0;
+    AlignedVector<double> data_;
+};
+
+// C += A B for row-major A (m × k), B (k × n) and C (m × n). Cache blocked over
+// k and n with a register-tiled micro-kernel. Every C element accumulates its
+// k products in ascending order, so a row of C does not depend on which other
+// rows are computed with it or on the blocking.
+void gemm(std::span<const double> a,
+          std::size_t m,
+          std::size_t k,
+          std::span<const double> b,
+          std::size_t n,
+          std::span<double> c);
+
+void gemm(const Matrix& a, const Matrix& b, Matrix& c);
+
+// The same product on sub-matrices with row strides lda, ldb and ldc; no
+// bounds are checked.
+void gemm_strided(const double* a,
+                  std::size_t lda,
+                  const double* b,
+                  std::size_t ldb,
+                  double* c,
+                  std::size_t ldc,
+                  std::size_t m,
+                  std::size_t k,
+                  std::size_t n);
+
+struct SymmetricEigen {
+    std::vector<double> values; // descending
+    Matrix vectors;             // row j: unit eigenvector of values[j]
+};
+
+// The `count` largest eigenpairs of a symmetric matrix, of which only the upper
+// triangle is read. Householder reduction to tridiagonal form (O(n^3)), implicit
+// QL for the eigenvalues, then inverse iteration on the tridiagonal matrix for
+// the wanted eigenvectors only, mapped back through the reflectors in
+// O(n^2 count). Throws std::invalid_argument if a is not square or count
+// exceeds its order, std::runtime_error if QL fails to converge.
+SymmetricEigen symmetric_eigen(const Matrix& a, std::size_t count);
+
+} // namespace linalg
+
+} // namespace risk
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+namespace risk {
+
+// Read-only memory mapping of a whole file. Pages are loaded on first touch,
+// so opening is O(1) and reading costs what the touched pages cost.
+class MappedFile {
+public:
+    MappedFile() = default;
+
+    // Throws std::runtime_error if the file cannot be opened or mapped.
+    explicit MappedFile(const std::string& path);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Empty for an empty file. Page-aligned otherwise.
+    [[nodiscard]] std::span<const std::byte> bytes() const noexcept { return {data_, size_}; }
+
+private:
+    void unmap() noexcept;
+
+    const std::byte* data_ = nullptr;
+    std::size_t size_ = 0;
+};
+
+} // namespace risk
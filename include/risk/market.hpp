@@ -6,11 +6,18 @@
 
 namespace risk {
 
+// Loads a "date,<ticker>..." closes file into the universe (set from the
+// header), dates and row-major prices. The file is memory-mapped and its rows
+// are parsed in newline-aligned chunks over `threads` workers (0: one per
+// hardware thread), straight into prices_flat. Blank lines are skipped. Returns
+// false after logging the first problem in file order (missing file or header,
+// wrong field count, a close that is not a positive number).
 bool load_closes_csv(const std::string& path,
                      std::vector<std::string>& dates,
                      std::vector<double>& prices_flat,
                      std::size_t& T,
-                     std::size_t& N);
+                     std::size_t& N,
+                     std::size_t threads = 1);
 
 void compute_shocks(const std::vector<double>& prices_flat,
                     std::size_t T,
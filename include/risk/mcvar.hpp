@@ -1,20 +1,117 @@
 #pragma once
 
+#include <cstddef>
 #include <cstdint>
 
 #include <risk/eigen_stub.hpp>
 
+#include <risk/factor_cache.hpp>
 #include <risk/hvar.hpp>
 #include <risk/instrument_soa.hpp>
+#include <risk/revaluation.hpp>
 
 namespace risk {
 
+// Where compute_mcvar draws its standard normals from.
+//   Pseudo: counter-based Philox stream per path (rng::path_normals).
+//   Sobol:  Owen-scrambled Sobol points (rng::SobolSequence), one dimension
+//           per factor. Converges faster; path counts that are powers of two
+//           keep the full net structure.
+enum class MonteCarloSampler : std::uint8_t { Pseudo = 0, Sobol = 1 };
+
+struct MonteCarloOptions {
+    MonteCarloSampler sampler = MonteCarloSampler::Pseudo;
+    // Path 2j + 1 uses the negated normals of path 2j.
+    bool antithetic = false;
+    // Shift the normals toward the portfolio's delta loss direction so about
+    // half the paths land beyond the linear VaR, and weight every path by its
+    // likelihood ratio. Not combinable with prune_tail or hybrid revaluation.
+    bool importance_sampling = false;
+    // 0: correlate the normals with the pivoted Cholesky factor of the
+    // covariance, which needs only as many normals as its numerical rank.
+    // k > 0: simulate the top k principal components plus one idiosyncratic
+    // normal per factor (see pca_factor_model), O(n k) per path instead of
+    // O(n^2). Variances are kept exactly; correlations only as far as the k
+    // components explain them.
+    std::size_t pca_factors = 0;
+    // If set, the path factors (Cholesky or PCA) are looked up by the content of
+    // the covariance they factor, and stored there after a miss. Cached factors
+    // are bit-identical to recomputed ones.
+    const FactorCache* factor_cache = nullptr;
+};
+
+// How the paths of a Monte Carlo run were generated.
+struct MonteCarloModel {
+    std::size_t factors = 0;          // universe factors simulated (those the portfolio references)
+    std::size_t normals = 0;          // standard normals per path
+    std::size_t pca_factors = 0;      // 0: full Cholesky
+    double explained_variance = 1.0;  // share of total variance the factors carry
+    // Full Cholesky only (pivoted_cholesky of the simulated covariance):
+    std::size_t rank = 0;
+    double condition = 0.0;
+    bool cached = false;              // factors loaded from sampling.factor_cache
+};
+
+// Only the factors the portfolio references (equity ids, option underlying
+// indices) are simulated, from their sub-covariance; a small book over a large
+// universe costs what its own factors cost. pca_factors is capped at that count.
+// Path p is a pure function of (seed, p) under either sampler, so the result
+// depends only on the seed and path count, not on revaluation.threads. The
+// returned standard errors come from 20 batches of paths (batch means); they
+// are zero under prune_tail.
+// Paths are generated per block and never stored; tail repricing regenerates
+// the paths it needs. In grid mode each option ladder spans drift +/- k sigma
+// of its underlying's log return, with k set so a path rarely leaves it; paths
+// that do are repriced in full and counted in stats->fallback_rows.
+// Throws std::invalid_argument if sampling.pca_factors exceeds the universe.
 RiskMetrics compute_mcvar(const InstrumentSoA& soa,
                           const Eigen::VectorXd& mu,
                           const Eigen::MatrixXd& cov,
                           double horizon_days,
                           double alpha,
                           int paths,
-                          std::uint64_t seed);
+                          std::uint64_t seed,
+                          const RevaluationOptions& revaluation = {},
+                          RevaluationStats* stats = nullptr,
+                          const MonteCarloOptions& sampling = {},
+                          MonteCarloModel* model = nullptr);
+
+// Sequential Monte Carlo: paths are priced in growing rounds, reusing every
+// path already priced, until the confidence intervals of VaR and ES are both
+// within `tolerance` of the estimate, max_paths is reached, or the time budget
+// would be exceeded by another round. Intervals are Student-t intervals on the
+// batch-means standard errors, which prune_tail does not provide, so it is
+// rejected, as is initial_paths below 40 (two paths per batch).
+struct AdaptiveMonteCarloOptions {
+    double tolerance = 0.01;          // target half-width relative to |VaR| and |ES|
+    double confidence = 0.95;
+    int initial_paths = 16384;
+    int max_paths = 1 << 22;
+    double time_budget_seconds = 0.0; // 0: no limit
+};
+
+struct AdaptiveMonteCarloResult {
+    RiskMetrics metrics;
+    std::size_t paths = 0;
+    double var_half_width = 0.0;
+    double cvar_half_width = 0.0;
+    double elapsed_seconds = 0.0;
+    bool converged = false; // tolerance met, rather than a path or time budget
+    MonteCarloModel model;
+};
+
+// Draws the same paths as compute_mcvar with the same seed and options; under
+// full and delta-gamma revaluation the result after n paths equals
+// compute_mcvar with paths = n. Grid ladders are sized for max_paths.
+AdaptiveMonteCarloResult compute_mcvar_adaptive(const InstrumentSoA& soa,
+                                                const Eigen::VectorXd& mu,
+                                                const Eigen::MatrixXd& cov,
+                                                double horizon_days,
+                                                double alpha,
+                                                std::uint64_t seed,
+                                                const AdaptiveMonteCarloOptions& adaptive,
+                                                const RevaluationOptions& revaluation = {},
+                                                RevaluationStats* stats = nullptr,
+                                                const MonteCarloOptions& sampling = {});
 
 } // namespace risk
@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <risk/instrument_soa.hpp>
+
+namespace risk {
+
+// Unique-contract view of a portfolio. Option lines are identical contracts when
+// they agree on (underlying_index, underlying spot, strike, time_to_maturity,
+// is_call, implied_vol, rate); equity lines when they agree on (id,
+// current_price). Contracts appear in order of first occurrence.
+struct NettedContracts {
+    InstrumentSoA contracts;                 // qty holds the net quantity across lines
+    std::vector<double> value_today;         // sum of qty * current_price over the contract's lines
+    std::vector<std::size_t> line_to_contract; // source line -> row of contracts
+};
+
+NettedContracts net_contracts(const InstrumentSoA& soa);
+
+} // namespace risk
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+
+namespace risk {
+
+// Worker count for a requested thread count; 0 means one per hardware thread.
+std::size_t resolve_thread_count(std::size_t threads);
+
+// Calls body(block, begin, end) once for every block [begin, end) of
+// block_size consecutive indices in [0, n). Blocks are claimed dynamically by
+// up to `threads` workers, the calling thread included, so the work a block
+// does must not depend on which worker runs it. The first exception thrown by
+// body is rethrown in the caller once all workers have stopped.
+void parallel_for(std::size_t n,
+                  std::size_t block_size,
+                  std::size_t threads,
+                  const std::function<void(std::size_t block, std::size_t begin, std::size_t end)>& body);
+
+} // namespace risk
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#include <risk/instrument_soa.hpp>
+
+namespace risk {
+
+// Compile-time instrument kinds. Kernels are templated on these so each
+// partition runs without per-instrument type or payoff dispatch.
+namespace kind {
+struct Equity {};
+struct Call {};
+struct Put {};
+} // namespace kind
+
+// InstrumentSoA split by kind. The split is stable, and each *_index maps a
+// partition row back to its position in the source portfolio.
+struct PartitionedSoA {
+    InstrumentSoA equities;
+    InstrumentSoA calls;
+    InstrumentSoA puts;
+    std::vector<std::size_t> equity_index;
+    std::vector<std::size_t> call_index;
+    std::vector<std::size_t> put_index;
+};
+
+PartitionedSoA partition_by_kind(const InstrumentSoA& soa);
+
+} // namespace risk
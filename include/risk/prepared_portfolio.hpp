@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <risk/aligned.hpp>
+#include <risk/instrument_soa.hpp>
+
+namespace risk {
+
+// Scenario-invariant columns for the unique contracts of one option partition.
+struct PreparedOptions {
+    AlignedVector<std::uint32_t> factor;
+    AlignedVector<double> spot;         // underlying today; zero prices the line at zero
+    AlignedVector<double> inv_strike;
+    AlignedVector<double> drift;        // (r + vol^2 / 2) * tau
+    AlignedVector<double> vol_sqrt_tau;
+    AlignedVector<double> disc_strike;  // strike * exp(-r * tau)
+    AlignedVector<double> qty;
+    double value_today = 0.0;
+
+    [[nodiscard]] std::size_t size() const noexcept { return factor.size(); }
+};
+
+struct ContractValue {
+    double price = 0.0;
+    double delta = 0.0; // d price / d spot
+};
+
+// Black-Scholes value of contract j of a prepared partition at the given spot,
+// evaluated with libm; zero for an unpriceable contract or a non-positive spot.
+ContractValue contract_value(const PreparedOptions& options, std::size_t j, double spot, bool is_call);
+
+// Scenario-invariant view of a portfolio. Everything that does not depend on the
+// shock row (index validation, the underlying fallback, vol/maturity clamps,
+// sqrt(tau), discounting) is computed once here, leaving revalue() with the
+// shocked spot, one log and two normal CDFs per option. Positions are split into
+// equity, call and put partitions, each revalued by its own kernel. Option lines
+// are netted first (see net_contracts), so each unique contract is priced once.
+//
+// Equity P&L is linear in the shocks, so all equity lines collapse into one dense
+// dollar exposure per factor. Across a whole shock matrix that is a single GEMV
+// (equity_pnl), and only options need per-scenario revaluation (option_pnl).
+//
+// Options are priced in blocks over the prepared columns, with the log and the
+// normal CDFs going through risk::vmath, so accuracy follows vmath::math_mode().
+// Per unit of quantity, each contract's shocked value differs from bs::price at
+// the shocked spot S by at most tolerance * (S + strike), with tolerance
+// kRevalueTolerance (Exact) or kFastRevalueTolerance (Fast). A relative bound
+// would not hold: the prepared 1 / strike and strike * exp(-r * tau) round
+// differently from bs::price's own expressions.
+inline constexpr double kRevalueTolerance = 1e-14;
+inline constexpr double kFastRevalueTolerance = 1e-13;
+
+class PreparedPortfolio {
+public:
+    PreparedPortfolio() = default;
+
+    // Throws std::out_of_range if any id or underlying_index is >= factor_count.
+    PreparedPortfolio(const InstrumentSoA& soa, std::size_t factor_count);
+
+    [[nodiscard]] std::size_t factor_count() const noexcept { return factor_count_; }
+    [[nodiscard]] std::size_t equity_count() const noexcept { return equity_count_; }
+    [[nodiscard]] std::size_t option_count() const noexcept { return option_count_; }
+    [[nodiscard]] std::size_t contract_count() const noexcept { return calls_.size() + puts_.size(); }
+
+    // Sum of price * qty over equity lines, indexed by factor.
+    [[nodiscard]] const AlignedVector<double>& equity_exposure() const noexcept { return equity_exposure_; }
+
+    // Prepared contracts of the call and put partitions.
+    [[nodiscard]] const PreparedOptions& calls() const noexcept { return calls_; }
+    [[nodiscard]] const PreparedOptions& puts() const noexcept { return puts_; }
+
+    // Portfolio P&L under one row of factor_count() shocks. Thread-safe.
+    [[nodiscard]] double revalue(const double* shocks_row) const;
+
+    // Equity P&L for each row of a row-major rows × factor_count() shock matrix.
+    void equity_pnl(std::span<const double> shocks_flat, std::size_t rows, std::span<double> out) const;
+
+    // Option P&L under one row of shocks; revalue() is equity plus option P&L.
+    [[nodiscard]] double option_pnl(const double* shocks_row) const;
+
+private:
+    std::size_t factor_count_ = 0;
+    std::size_t equity_count_ = 0;
+    std::size_t option_count_ = 0;
+    AlignedVector<double> equity_exposure_;
+    PreparedOptions calls_;
+    PreparedOptions puts_;
+};
+
+} // namespace risk
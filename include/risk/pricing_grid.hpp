@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <risk/aligned.hpp>
+#include <risk/prepared_portfolio.hpp>
+#include <risk/revaluation.hpp>
+
+namespace risk {
+
+// Per-column min/max of a row-major rows × cols shock matrix.
+std::vector<ShockRange> shock_ranges(std::span<const double> shocks_flat, std::size_t rows, std::size_t cols);
+
+// Option P&L as a function of one shock per underlying. Option value depends on
+// the scenario only through the shocked spot of its underlying, so the values of
+// all contracts on a factor are summed into one curve, tabulated on an evenly
+// spaced ladder of shocks with analytic deltas, and evaluated by cubic Hermite
+// interpolation. The interpolant is linear in the node values and slopes, so the
+// summed curve interpolates exactly like pricing each contract on its own grid;
+// the error is O(h^4) away from the zero-spot kink.
+class PricingGrid {
+public:
+    PricingGrid() = default;
+
+    // ranges holds one entry per factor; only factors with options are tabulated.
+    // Throws std::invalid_argument if nodes < 2 or ranges has the wrong size.
+    PricingGrid(const PreparedPortfolio& prepared, std::span<const ShockRange> ranges, std::size_t nodes);
+
+    [[nodiscard]] std::size_t node_count() const noexcept { return nodes_; }
+    [[nodiscard]] std::size_t underlying_count() const noexcept { return factors_.size(); }
+
+    // True when every tabulated factor's shock lies inside its ladder.
+    [[nodiscard]] bool covers(const double* shocks_row) const;
+
+    // Interpolated option P&L; only meaningful when covers(shocks_row).
+    [[nodiscard]] double option_pnl(const double* shocks_row) const;
+
+private:
+    std::size_t nodes_ = 0;
+    double value_today_ = 0.0;
+    std::vector<std::uint32_t> factors_;
+    std::vector<double> lo_;
+    std::vector<double> hi_;
+    std::vector<double> step_;
+    AlignedVector<double> value_; // factors_.size() × nodes_
+    AlignedVector<double> slope_; // d value / d shock, scaled by step_
+};
+
+// Option P&L on a grid for a stream of scenarios. Rows the grid does not cover
+// are repriced in full, and an evenly spaced sample of check_rows rows is priced
+// both ways for the error statistics.
+//
+// Not thread-safe; parallel callers use one revaluer per block of rows and
+// merge them in block order.
+class GridRevaluer {
+public:
+    GridRevaluer(const PreparedPortfolio& prepared,
+                 const PricingGrid& grid,
+                 std::size_t rows,
+                 std::size_t check_rows);
+
+    double option_pnl(std::size_t row_index, const double* shocks_row);
+
+    // Folds in the statistics of a revaluer that handled other rows.
+    void merge(const GridRevaluer& other);
+
+    [[nodiscard]] RevaluationStats stats() const;
+
+private:
+    const PreparedPortfolio& prepared_;
+    const PricingGrid& grid_;
+    std::size_t check_stride_ = 0;
+    RevaluationStats stats_;
+    double sum_sq_error_ = 0.0;
+};
+
+} // namespace risk
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include <risk/instrument_soa.hpp>
+
+namespace risk {
+
+struct RiskMetrics {
+    double var = 0.0;
+    double cvar = 0.0;
+    // Batch-means standard errors (ScenarioSet::error_batches); zero when not
+    // estimated.
+    double var_stderr = 0.0;
+    double cvar_stderr = 0.0;
+};
+
+struct ShockRange {
+    double lo = 0.0;
+    double hi = 0.0;
+};
+
+// How compute_hvar / compute_mcvar revalue options per scenario.
+//   Full:       Black-Scholes for every contract in every scenario.
+//   Grid:       spot-ladder interpolation (see PricingGrid).
+//   DeltaGamma: second-order Taylor expansion from the portfolio greeks.
+//   Hybrid:     DeltaGamma for every scenario, then full repricing of every
+//               scenario whose P&L bounds (see PnlBounds) can reach the tail
+//               (see refine_tail). VaR and ES are bit-identical to Full.
+enum class RevaluationMode : std::uint8_t { Full = 0, Grid = 1, DeltaGamma = 2, Hybrid = 3 };
+
+struct RevaluationOptions {
+    RevaluationMode mode = RevaluationMode::Full;
+    std::size_t grid_nodes = 256;
+    std::size_t grid_check_rows = 256; // scenarios also repriced in full to measure grid error
+
+    // Full mode in compute_hvar only: bound every scenario's P&L first and
+    // reprice only those that can reach the tail (see tail_candidates). The
+    // result is bit-identical to repricing every scenario.
+    bool prune_tail = false;
+    std::size_t bound_nodes = 64; // P&L bound ladder, for pruning and hybrid mode
+
+    // Scenario blocks are spread over `threads` workers (0: one per hardware
+    // thread). Blocks are fixed by block_rows alone (0: sized to keep a block of
+    // shock rows in L2), so results do not depend on the thread count.
+    std::size_t threads = 1;
+    std::size_t block_rows = 0;
+};
+
+struct RevaluationStats {
+    std::size_t option_lines = 0;    // option positions in the portfolio
+    std::size_t contracts = 0;       // unique contracts they net into (see net_contracts)
+    std::size_t grid_nodes = 0;      // zero when the grid was not used
+    std::size_t fallback_rows = 0;   // scenarios outside the ladder, repriced in full
+    std::size_t full_rows = 0;       // scenarios repriced in full by hybrid mode
+    std::size_t pruned_rows = 0;     // scenarios prune_tail proved outside the tail
+    std::size_t checked_rows = 0;
+    double max_abs_error = 0.0;      // approximate vs full P&L over the checked rows
+    double rms_error = 0.0;
+};
+
+// Rows [begin, end) of a scenario set as a row-major block of shocks. A source
+// either returns a view of stored rows or fills scratch and returns that. It is
+// called concurrently from worker threads and must return the same rows for
+// the same range on every call.
+using ScenarioBlock =
+    std::function<std::span<const double>(std::size_t begin, std::size_t end, std::vector<double>& scratch)>;
+
+// Likelihood ratios of rows [begin, end) for scenarios drawn from a proposal
+// distribution. Same calling contract as ScenarioBlock.
+using ScenarioWeights = std::function<void(std::size_t begin, std::size_t end, std::span<double> out)>;
+
+struct ScenarioSet {
+    std::size_t rows = 0;
+    std::size_t factors = 0;
+    ScenarioBlock block;
+    // Empty: rows are equally likely. Otherwise the quantile and the tail mean
+    // are likelihood-ratio weighted; pruning and hybrid revaluation rely on a
+    // fixed quantile index and are rejected.
+    ScenarioWeights weights;
+    // More than one: estimate standard errors from the spread of the metrics
+    // over this many contiguous batches of rows. Batch boundaries are even, so
+    // antithetic pairs never straddle two batches. Not available with pruning,
+    // which leaves most rows unpriced.
+    std::size_t error_batches = 0;
+    // Per factor: the shock range grids and P&L bounds are tabulated over. Rows
+    // outside it are still valued exactly (grid fallback, unbounded scenario).
+    std::vector<ShockRange> ranges;
+};
+
+// VaR and ES at level alpha over a growing prefix of a scenario set, for
+// sequential sampling. Everything scenario-invariant (prepared portfolio, grid,
+// P&L bounds, Taylor model) is built once; extend() prices only the new rows
+// and metrics() reads the result over the rows priced so far. scenarios.rows
+// is the capacity, which also sizes the grid error-check stride.
+class ScenarioRisk {
+public:
+    // Throws std::invalid_argument for an empty or inconsistent scenario set.
+    ScenarioRisk(const InstrumentSoA& soa,
+                 const ScenarioSet& scenarios,
+                 double alpha,
+                 const RevaluationOptions& options);
+    ~ScenarioRisk();
+
+    ScenarioRisk(const ScenarioRisk&) = delete;
+    ScenarioRisk& operator=(const ScenarioRisk&) = delete;
+
+    // Prices rows [rows(), rows). Throws std::out_of_range past the capacity.
+    void extend(std::size_t rows);
+
+    [[nodiscard]] std::size_t rows() const noexcept;
+
+    // Hybrid mode and pruning reprice their tail candidates on every call.
+    // Throws std::logic_error before the first row is priced.
+    RiskMetrics metrics(RevaluationStats* stats = nullptr);
+
+private:
+    struct Impl;
+    std::unique_ptr<Impl> impl_;
+};
+
+// VaR and ES at level alpha of the portfolio P&L over a scenario set, with
+// options revalued as selected by options. The inputs are assumed validated by
+// the caller (compute_hvar / compute_mcvar).
+RiskMetrics scenario_risk(const InstrumentSoA& soa,
+                          const ScenarioSet& scenarios,
+                          double alpha,
+                          const RevaluationOptions& options,
+                          RevaluationStats* stats);
+
+} // namespace risk
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace risk {
+
+namespace rng {
+
+using PhiloxCounter = std::array<std::uint32_t, 4>;
+using PhiloxKey = std::array<std::uint32_t, 2>;
+
+// Philox4x32-10 (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3").
+// A bijection of the counter under the key: every counter value yields 128
+// independent-looking bits, so any draw can be computed without the ones
+// before it.
+inline PhiloxCounter philox4x32(PhiloxCounter ctr, PhiloxKey key) noexcept {
+    constexpr std::uint64_t kMul0 = 0xD2511F53U;
+    constexpr std::uint64_t kMul1 = 0xCD9E8D57U;
+    constexpr std::uint32_t kWeyl0 = 0x9E3779B9U;
+    constexpr std::uint32_t kWeyl1 = 0xBB67AE85U;
+    for (int round = 0; round < 10; ++round) {
+        const std::uint64_t p0 = kMul0 * ctr[0];
+        const std::uint64_t p1 = kMul1 * ctr[2];
+        ctr = {static_cast<std::uint32_t>(p1 >> 32) ^ ctr[1] ^ key[0],
+               static_cast<std::uint32_t>(p1),
+               static_cast<std::uint32_t>(p0 >> 32) ^ ctr[3] ^ key[1],
+               static_cast<std::uint32_t>(p0)};
+        key[0] += kWeyl0;
+        key[1] += kWeyl1;
+    }
+    return ctr;
+}
+
+// Maps 64 random bits to a double in the open interval (0, 1). 52 bits keep
+// both ends, 2^-53 and 1 - 2^-53, exactly representable.
+inline double to_unit_open(std::uint64_t bits) noexcept {
+    return (static_cast<double>(bits >> 12) + 0.5) * 0x1p-52;
+}
+
+// Uniforms on (0, 1) for stream `stream` under `seed`: out[i] depends only on
+// (seed, stream, i), never on which thread draws it or what was drawn before.
+// Counter (i / 2, stream, 0) keyed by the seed gives two uniforms per Philox
+// block.
+void uniform_open(std::uint64_t seed, std::uint64_t stream, std::span<double> out);
+
+// Standard normals for Monte Carlo path `path`: the uniforms of stream `path`
+// mapped through normal_quantile (gaussian.hpp).
+void path_normals(std::uint64_t seed, std::uint64_t path, std::span<double> out);
+
+} // namespace rng
+
+} // namespace risk
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include <risk/aligned.hpp>
+
+namespace risk {
+
+namespace rng {
+
+// Owen-scrambled Sobol sequence. Dimension 0 is the van der Corput sequence;
+// dimension d > 0 uses the d-th primitive polynomial over GF(2) in order of
+// degree, with the Joe-Kuo initial direction numbers (new-joe-kuo-6.21201) up to
+// dimension 480 and fixed pseudo-random ones beyond. Each dimension is
+// scrambled with the hash-based nested uniform scramble of Burley ("Practical
+// Hash-based Owen Scrambling", 2020), keyed by the seed, which keeps the net
+// structure and makes the estimator unbiased.
+//
+// Points are 32-bit, so at most 2^32 of them. Point i of every dimension
+// depends only on (seed, i); blocks of rows can be drawn in any order.
+class SobolSequence {
+public:
+    static constexpr std::uint64_t kMaxPoints = std::uint64_t{1} << 32;
+
+    // Throws std::invalid_argument if dimensions is zero.
+    SobolSequence(std::size_t dimensions, std::uint64_t seed);
+
+    [[nodiscard]] std::size_t dimensions() const noexcept { return dimensions_; }
+
+    // Points [begin, end) as a row-major (end - begin) × dimensions() block of
+    // uniforms on (0, 1). Throws std::out_of_range past kMaxPoints and
+    // std::invalid_argument if out has the wrong size.
+    void uniforms(std::uint64_t begin, std::uint64_t end, std::span<double> out) const;
+
+    // The same points mapped to standard normals by normal_quantile.
+    void normals(std::uint64_t begin, std::uint64_t end, std::span<double> out) const;
+
+private:
+    static constexpr std::size_t kBits = 32;
+
+    std::size_t dimensions_ = 0;
+    AlignedVector<std::uint32_t> directions_; // dimensions × kBits
+    AlignedVector<std::uint32_t> scramble_;   // per dimension
+};
+
+} // namespace rng
+
+} // namespace risk
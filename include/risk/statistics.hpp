@@ -0,0 +1,136 @@
+#pragma once
+
+#include <cstddef>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include <risk/aligned.hpp>
+#include <risk/eigen_stub.hpp>
+#include <risk/factor_cache.hpp>
+#include <risk/linalg.hpp>
+
+namespace risk {
+
+// Column means of a row-major scenarios x factors shock matrix. Each mean is
+// summed in scenario order, so the result does not depend on threads.
+// Throws std::invalid_argument on empty or mismatched dimensions.
+Eigen::VectorXd compute_sample_mean(std::span<const double> shocks,
+                                    std::size_t scenarios,
+                                    std::size_t factors,
+                                    std::size_t threads = 1);
+
+// Unbiased sample covariance (divisor scenarios - 1) of the same matrix about
+// `mean`; all zeros for a single scenario. A SYRK-style kernel: the centred
+// shocks D give D^T D through the blocked gemm, one 64-row block of the upper
+// triangle per task, mirrored into the lower one. The result is exactly
+// symmetric and the same for every thread count.
+// Throws std::invalid_argument on empty or mismatched dimensions.
+Eigen::MatrixXd compute_sample_covariance(std::span<const double> shocks,
+                                          const Eigen::VectorXd& mean,
+                                          std::size_t scenarios,
+                                          std::size_t factors,
+                                          std::size_t threads = 1);
+
+// Mean and covariance of a sliding window of shock rows, kept current one row
+// at a time: push adds a row and pop removes one pushed earlier (typically the
+// oldest), each in O(N^2) by Welford's updates of the mean and of the scatter
+// matrix S = sum (x - mean)(x - mean)^T. Once factorize() has succeeded the
+// Cholesky factor of S follows along by rank-one update/downdate, so the
+// covariance factor costs O(N^2) per row instead of O(N^3).
+class RollingMoments {
+public:
+    explicit RollingMoments(std::size_t factors);
+
+    // A window holding the rows of a scenarios x factors shock matrix (the CSV
+    // path), computed with the kernels above.
+    RollingMoments(std::span<const double> shocks, std::size_t scenarios, std::size_t factors, std::size_t threads = 1);
+
+    // A window of `count` rows known only by their moments (the precomputed mean
+    // and covariance of the KDB+ path).
+    RollingMoments(const Eigen::VectorXd& mean, const Eigen::MatrixXd& covariance, std::size_t count);
+
+    // Throw std::invalid_argument if the row has the wrong length, and pop on an
+    // empty window. If removing the row leaves no more rows than factors, or
+    // S not positive definite to working precision, the factor is dropped
+    // (has_factor() turns false) until the next factorize().
+    void push(std::span<const double> row);
+    void pop(std::span<const double> row);
+
+    [[nodiscard]] std::size_t factors() const noexcept { return factors_; }
+    [[nodiscard]] std::size_t count() const noexcept { return count_; }
+    [[nodiscard]] std::span<const double> mean() const noexcept { return mean_; }
+
+    [[nodiscard]] Eigen::VectorXd mean_vector() const;
+    // Unbiased (divisor count - 1); zero below two rows.
+    [[nodiscard]] Eigen::MatrixXd covariance() const;
+
+    // Factors S from scratch with linalg::cholesky. Returns false, without a
+    // factor, if the covariance is not positive definite (e.g. fewer rows than
+    // factors).
+    bool factorize(std::size_t threads = 1);
+    [[nodiscard]] bool has_factor() const noexcept { return has_factor_; }
+    // Lower Cholesky factor of covariance(). Throws std::logic_error without one.
+    [[nodiscard]] linalg::Matrix covariance_factor() const;
+
+private:
+    void check_row(std::span<const double> row) const;
+
+    std::size_t factors_ = 0;
+    std::size_t count_ = 0;
+    AlignedVector<double> mean_;
+    linalg::Matrix scatter_;        // upper triangle of S
+    linalg::Matrix scatter_factor_; // lower Cholesky factor of S
+    bool has_factor_ = false;
+    std::vector<double> delta_;
+};
+
+// Exponentially weighted (RiskMetrics-style) moments of a stream of shock rows,
+// O(N^2) per day. With weight a = 1 - decay and d = row - mean, each day does
+//   mean += a d,    cov = decay (cov + a d d^T)
+// (Finch's incremental form), so a day k days old carries weight a decay^k. The
+// first day sets the mean and leaves the covariance zero.
+class EwmaCovariance {
+public:
+    // Throws std::invalid_argument unless factors > 0 and 0 < decay < 1.
+    explicit EwmaCovariance(std::size_t factors, double decay = 0.94);
+
+    // Throws std::invalid_argument if the row has the wrong length.
+    void update(std::span<const double> row);
+
+    [[nodiscard]] std::size_t factors() const noexcept { return factors_; }
+    [[nodiscard]] double decay() const noexcept { return decay_; }
+    [[nodiscard]] std::size_t days() const noexcept { return days_; }
+
+    [[nodiscard]] Eigen::VectorXd mean() const;
+    [[nodiscard]] Eigen::MatrixXd covariance() const;
+
+    // Checkpoints: the state is stored under key and restored bit for bit.
+    // restore returns nullopt if there is no usable entry for the key.
+    bool save(const FactorCache& cache, const CacheKey& key) const;
+    [[nodiscard]] static std::optional<EwmaCovariance> restore(const FactorCache& cache, const CacheKey& key);
+
+private:
+    std::size_t factors_ = 0;
+    double decay_ = 0.0;
+    std::size_t days_ = 0;
+    AlignedVector<double> mean_;
+    linalg::Matrix covariance_; // upper triangle
+    std::vector<double> delta_;
+};
+
+// EWMA moments of a scenarios x factors shock history, day by day in order.
+// With a cache, every checkpoint is keyed by the decay and the content of the
+// days it has seen: the run resumes from the checkpoint of the longest prefix
+// of this history up to max_resume_days shorter, replays only the days after
+// it, and checkpoints the result, so a daily run costs one day's update.
+// *replayed (if given) receives the number of days streamed.
+EwmaCovariance ewma_covariance(std::span<const double> shocks,
+                               std::size_t scenarios,
+                               std::size_t factors,
+                               double decay,
+                               const FactorCache* cache = nullptr,
+                               std::size_t max_resume_days = 64,
+                               std::size_t* replayed = nullptr);
+
+} // namespace risk
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <risk/aligned.hpp>
+#include <risk/pricing_grid.hpp>
+#include <risk/prepared_portfolio.hpp>
+
+namespace risk {
+
+// Rigorous lower/upper bounds on option P&L per scenario. Black-Scholes values
+// are convex in spot, so on each underlying the long positions sum to a convex
+// curve and the short positions to a concave one. Both are tabulated, with
+// analytic slopes, on a ladder of shocks. Between two nodes a convex curve lies
+// below its chord and above both end tangents (concave: the reverse), so the
+// bracket width shrinks with the square of the node spacing. The bounds are
+// widened by a small slack that covers rounding and the fast math kernels.
+class PnlBounds {
+public:
+    PnlBounds() = default;
+
+    // Throws std::invalid_argument if nodes < 2 or ranges has the wrong size.
+    PnlBounds(const PreparedPortfolio& prepared, std::span<const ShockRange> ranges, std::size_t nodes);
+
+    // Scenarios outside the ladder get infinite bounds.
+    void option_bounds(const double* shocks_row, double& lower, double& upper) const;
+
+private:
+    [[nodiscard]] double node(std::size_t f, std::size_t k) const;
+
+    std::size_t nodes_ = 0;
+    double value_today_ = 0.0;
+    double slack_ = 0.0;
+    std::vector<std::uint32_t> factors_;
+    std::vector<double> lo_;
+    std::vector<double> hi_;
+    std::vector<double> step_;
+    AlignedVector<double> convex_;        // factors_.size() × nodes_
+    AlignedVector<double> convex_slope_;  // d value / d shock
+    AlignedVector<double> concave_;
+    AlignedVector<double> concave_slope_;
+};
+
+// Scenarios that can reach the q-quantile tail, in ascending order. pnl_t lies
+// in [lower[t], upper[t]]; with k = floor(q * (n - 1)), at least k + 1
+// scenarios have P&L at most the (k + 1)-th smallest upper bound, so the
+// quantile cannot exceed it and any scenario whose lower bound does is pruned.
+std::vector<std::size_t> tail_candidates(std::span<const double> lower, std::span<const double> upper, double q);
+
+} // namespace risk
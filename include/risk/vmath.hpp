@@ -0,0 +1,196 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+namespace risk {
+
+namespace vmath {
+
+// Exact routes every element through libm. Fast uses the branch-free polynomial
+// kernels below, which the compiler vectorizes to the host SIMD width. sqrt has
+// no fast variant: the hardware instruction is already vectorized and exact.
+enum class MathMode : std::uint8_t { Exact = 0, Fast = 1 };
+
+void set_math_mode(MathMode mode);
+MathMode math_mode();
+
+// Max errors of the fast kernels against libm, as checked by test_vmath.cpp.
+inline constexpr double kFastExpMaxRelError = 1e-15;       // x in [-708, 709]
+inline constexpr double kFastExpm1MaxRelError = 5e-15;     // x in [-708, 709]
+inline constexpr double kFastLogMaxAbsError = 1e-15;       // x positive and normal, scaled by max(1, |log x|)
+inline constexpr double kFastNormalCdfMaxAbsError = 1e-15; // all finite x
+inline constexpr double kFastNormalCdfMaxRelError = 5e-13; // x >= -37 (lower tail)
+
+namespace detail {
+
+inline constexpr double kLn2Hi = 6.93147180369123816490e-01;
+inline constexpr double kLn2Lo = 1.90821492927058770002e-10;
+inline constexpr double kLog2e = 1.44269504088896338700e+00;
+inline constexpr double kSqrt2 = 1.41421356237309514547e+00;
+inline constexpr double kInvSqrt2 = 7.07106781186547572737e-01;
+inline constexpr double kInvSqrt2Pi = 3.98942280401432702863e-01;
+inline constexpr double kShifter = 0x1.8p52;
+inline constexpr double kExpMin = -708.0;
+inline constexpr double kExpMax = 709.0;
+
+// Polynomial in u = 2t - 1 (coefficients by ascending power) for
+// log(erfc(z)) + z^2 - log(t), t = 1 / (1 + z/2). Obtained from a degree-27
+// Chebyshev fit in quad precision; truncation error is below 1e-16 and the
+// monomial form is well conditioned on [-1, 1] (sum of |a_k| is about 1.46).
+inline constexpr double kErfcPoly[] = {
+    -6.71794084056692276e-01,
+     6.72643223977656746e-01,
+     4.73433068419044298e-02,
+    -4.68956102311752984e-02,
+    -9.87268936638995877e-03,
+     8.82493855706062251e-03,
+     1.75893355779901603e-03,
+    -2.34581250048285315e-03,
+    -1.46246863378003363e-04,
+     6.73678795580234975e-04,
+    -9.37350311709816991e-05,
+    -1.74302947203076213e-04,
+     7.14010141275703053e-05,
+     3.17451797494374026e-05,
+    -3.01878845513942428e-05,
+     1.37726641344644175e-07,
+     8.56262342012128561e-06,
+    -2.94798687699825905e-06,
+    -1.27231190486886995e-06,
+     1.25002766125697536e-06,
+    -1.68498007206532973e-07,
+    -2.49583276171966708e-07,
+     1.53343459209081768e-07,
+     1.44486580462526963e-09,
+    -3.91718205102718551e-08,
+     1.11723522636237570e-08,
+     4.06088214696972020e-09,
+    -1.89023060089445374e-09,
+};
+
+} // namespace detail
+
+// exp(x) for x in [-708, 709]; inputs outside are clamped to that range.
+inline double fast_exp(double x) noexcept {
+    using namespace detail;
+    x = x < kExpMin ? kExpMin : x;
+    x = x > kExpMax ? kExpMax : x;
+
+    // Round x / ln2 to the nearest integer n with the 1.5 * 2^52 shifter; the low
+    // mantissa bits of `shifted` then hold n in two's complement.
+    const double shifted = x * kLog2e + kShifter;
+    const double n = shifted - kShifter;
+    const double r = (x - n * kLn2Hi) - n * kLn2Lo;
+
+    // Taylor series on |r| <= ln2 / 2; the first dropped term is below 2e-16.
+    double p = 1.0 / 479001600.0;
+    p = p * r + 1.0 / 39916800.0;
+    p = p * r + 1.0 / 3628800.0;
+    p = p * r + 1.0 / 362880.0;
+    p = p * r + 1.0 / 40320.0;
+    p = p * r + 1.0 / 5040.0;
+    p = p * r + 1.0 / 720.0;
+    p = p * r + 1.0 / 120.0;
+    p = p * r + 1.0 / 24.0;
+    p = p * r + 1.0 / 6.0;
+    p = p * r + 0.5;
+    p = p * r + 1.0;
+    p = p * r + 1.0;
+
+    const std::uint64_t scale_bits = (std::bit_cast<std::uint64_t>(shifted) + 1023U) << 52;
+    return p * std::bit_cast<double>(scale_bits);
+}
+
+// expm1(x) for x in [-708, 709]. Near zero the series for (e^x - 1) / x is
+// used directly so small results keep full relative precision; elsewhere
+// e^x - 1 cancels at most a factor of about 3.5.
+inline double fast_expm1(double x) noexcept {
+    // Taylor series on |x| <= ln2 / 2; the first dropped term is below 5e-16 * |x|.
+    double q = 1.0 / 479001600.0;
+    q = q * x + 1.0 / 39916800.0;
+    q = q * x + 1.0 / 3628800.0;
+    q = q * x + 1.0 / 362880.0;
+    q = q * x + 1.0 / 40320.0;
+    q = q * x + 1.0 / 5040.0;
+    q = q * x + 1.0 / 720.0;
+    q = q * x + 1.0 / 120.0;
+    q = q * x + 1.0 / 24.0;
+    q = q * x + 1.0 / 6.0;
+    q = q * x + 0.5;
+    q = q * x + 1.0;
+    const double small = x * q;
+    const double large = fast_exp(x) - 1.0;
+    return (x < 0.0 ? -x : x) <= 0.5 * detail::kLn2Hi ? small : large;
+}
+
+// log(x) for positive, normal, finite x.
+inline double fast_log(double x) noexcept {
+    using namespace detail;
+    const std::uint64_t bits = std::bit_cast<std::uint64_t>(x);
+
+    // x = 2^e * m. The biased exponent is turned into a double through the 2^52
+    // mantissa trick, which stays in integer SIMD lanes on AVX2.
+    double e = std::bit_cast<double>((bits >> 52) | 0x4330000000000000ULL) - (0x1p52 + 1023.0);
+    double m = std::bit_cast<double>((bits & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL);
+
+    // Recentre m into [sqrt(1/2), sqrt(2)) so the atanh series below converges quickly.
+    const bool high = m > kSqrt2;
+    m = high ? 0.5 * m : m;
+    e = high ? e + 1.0 : e;
+
+    // log(m) = 2 atanh(f), f = (m - 1) / (m + 1), |f| <= 0.1716.
+    const double f = (m - 1.0) / (m + 1.0);
+    const double f2 = f * f;
+    double p = 1.0 / 21.0;
+    p = p * f2 + 1.0 / 19.0;
+    p = p * f2 + 1.0 / 17.0;
+    p = p * f2 + 1.0 / 15.0;
+    p = p * f2 + 1.0 / 13.0;
+    p = p * f2 + 1.0 / 11.0;
+    p = p * f2 + 1.0 / 9.0;
+    p = p * f2 + 1.0 / 7.0;
+    p = p * f2 + 1.0 / 5.0;
+    p = p * f2 + 1.0 / 3.0;
+    p = p * f2 + 1.0;
+
+    return e * kLn2Hi + (2.0 * f * p + e * kLn2Lo);
+}
+
+inline double fast_normal_pdf(double x) noexcept {
+    return detail::kInvSqrt2Pi * fast_exp(-0.5 * x * x);
+}
+
+inline double fast_normal_cdf(double x) noexcept {
+    using namespace detail;
+    const double z = (x < 0.0 ? -x : x) * kInvSqrt2;
+    const double t = 1.0 / (1.0 + 0.5 * z);
+    const double u = 2.0 * t - 1.0;
+
+    // Horner with a constant trip count. It must unroll completely or the
+    // enclosing element loop will not vectorize.
+    constexpr std::size_t terms = sizeof(kErfcPoly) / sizeof(kErfcPoly[0]);
+    double series = kErfcPoly[terms - 1];
+#pragma GCC unroll 32
+    for (std::size_t j = terms - 1; j >= 1; --j) {
+        series = series * u + kErfcPoly[j - 1];
+    }
+
+    // erfc(z) = t * exp(series - z^2), with z^2 formed as x^2 / 2 to save a rounding.
+    const double half_erfc = 0.5 * t * fast_exp(series - 0.5 * x * x);
+    return x < 0.0 ? half_erfc : 1.0 - half_erfc;
+}
+
+// Element-wise kernels dispatching on math_mode(). out must have x.size()
+// elements and may alias x.
+void exp(std::span<const double> x, std::span<double> out);
+void expm1(std::span<const double> x, std::span<double> out);
+void log(std::span<const double> x, std::span<double> out);
+void normal_cdf(std::span<const double> x, std::span<double> out);
+void normal_pdf(std::span<const double> x, std::span<double> out);
+
+} // namespace vmath
+
+} // namespace risk
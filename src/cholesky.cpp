@@ -0,0 +1,248 @@
+#include <risk/cholesky.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <risk/parallel.hpp>
+
+namespace risk {
+
+namespace linalg {
+
+namespace {
+
+// Columns per panel, and trailing-update rows per parallel task.
+constexpr std::size_t kPanel = 64;
+constexpr std::size_t kUpdateRows = 64;
+
+double panel_dot(const Matrix& w, std::size_t i, std::size_t j, std::size_t begin) {
+    const double* x = w.row(i).data();
+    const double* y = w.row(j).data();
+    double sum = 0.0;
+    for (std::size_t k = begin; k < j; ++k) {
+        sum += x[k] * y[k];
+    }
+    return sum;
+}
+
+// Swaps rows and columns p < q of a symmetric matrix held in its lower triangle;
+// the already factored columns left of p move with their rows.
+void symmetric_swap(Matrix& w, std::size_t p, std::size_t q) {
+    const std::size_t n = w.rows();
+    for (std::size_t k = 0; k < p; ++k) {
+        std::swap(w(p, k), w(q, k));
+    }
+    for (std::size_t k = p + 1; k < q; ++k) {
+        std::swap(w(k, p), w(q, k));
+    }
+    for (std::size_t k = q + 1; k < n; ++k) {
+        std::swap(w(k, p), w(k, q));
+    }
+    std::swap(w(p, p), w(q, q));
+}
+
+// Trailing update A22 -= L21 L21^T on the lower triangle (rows and columns from
+// `end` on) for the panel of columns [begin, end).
+void update_trailing(Matrix& w, std::size_t begin, std::size_t end, std::size_t threads) {
+    const std::size_t n = w.rows();
+    const std::size_t m = n - end;
+    const std::size_t p = end - begin;
+    std::vector<double> minus_l21(m * p);
+    std::vector<double> l21_t(p * m);
+    for (std::size_t i = 0; i < m; ++i) {
+        for (std::size_t k = 0; k < p; ++k) {
+            const double value = w(end + i, begin + k);
+            minus_l21[i * p + k] = -value;
+            l21_t[k * m + i] = value;
+        }
+    }
+    // Row block [r0, r1) needs columns [0, r1) only; the strip above the
+    // diagonal it also writes is never read.
+    double* trailing = w.values().data() + end * n + end;
+    parallel_for(m, kUpdateRows, threads, [&](std::size_t, std::size_t r0, std::size_t r1) {
+        gemm_strided(minus_l21.data() + r0 * p, p, l21_t.data(), m, trailing + r0 * n, n, r1 - r0, p, r1);
+    });
+}
+
+// Blocked right-looking factorization of w in place (lower triangle). With
+// pivoting, stops once the largest remaining diagonal is at most tolerance and
+// returns the rank; without, throws on a non-positive pivot.
+std::size_t factorize(Matrix& w, bool pivot, double tolerance, std::size_t threads, std::vector<std::size_t>& pivots) {
+    const std::size_t n = w.rows();
+    pivots.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        pivots[i] = i;
+    }
+    // Diagonal of the Schur complement, kept current within a panel.
+    std::vector<double> d(n);
+    for (std::size_t begin = 0; begin < n; begin += kPanel) {
+        const std::size_t end = std::min(begin + kPanel, n);
+        for (std::size_t i = begin; i < n; ++i) {
+            d[i] = w(i, i);
+        }
+        for (std::size_t j = begin; j < end; ++j) {
+            if (pivot) {
+                const auto best = std::max_element(d.begin() + static_cast<std::ptrdiff_t>(j), d.end());
+                const auto q = static_cast<std::size_t>(best - d.begin());
+                if (!(*best > tolerance)) {
+                    return j;
+                }
+                if (q != j) {
+                    symmetric_swap(w, j, q);
+                    std::swap(d[j], d[q]);
+                    std::swap(pivots[j], pivots[q]);
+                }
+            } else if (!(d[j] > 0.0) || !std::isfinite(d[j])) {
+                throw std::invalid_argument("matrix is not positive definite");
+            }
+            const double ljj = std::sqrt(d[j]);
+            w(j, j) = ljj;
+            for (std::size_t i = j + 1; i < n; ++i) {
+                const double lij = (w(i, j) - panel_dot(w, i, j, begin)) / ljj;
+                w(i, j) = lij;
+                d[i] -= lij * lij;
+            }
+        }
+        if (end < n) {
+            update_trailing(w, begin, end, threads);
+        }
+    }
+    return n;
+}
+
+void check_rank_one(const Matrix& l, std::span<const double> x, const char* name) {
+    const std::size_t n = l.rows();
+    if (l.cols() != n || x.size() != n) {
+        throw std::invalid_argument(std::string(name) + " dimension mismatch");
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!(l(i, i) > 0.0)) {
+            throw std::invalid_argument(std::string(name) + " requires a positive diagonal");
+        }
+    }
+}
+
+// Row i of the new factor needs the rotations (c_k, s_k) of every row k < i and
+// the entry of x they have rotated into position i; rows are swept in order so
+// each is read and written contiguously. sign is +1 to add x x^T, -1 to remove
+// it. A downdate stops, returning false with l partly modified, at a pivot that
+// loses all but n eps of its square: the result would be singular or indefinite
+// to working precision.
+bool rank_one(Matrix& l, std::span<const double> x, double sign) {
+    const std::size_t n = l.rows();
+    const double tolerance = static_cast<double>(n) * std::numeric_limits<double>::epsilon();
+    std::vector<double> c(n);
+    std::vector<double> s(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        double* row = l.row(i).data();
+        double xi = x[i];
+        for (std::size_t k = 0; k < i; ++k) {
+            const double lik = (row[k] + sign * s[k] * xi) / c[k];
+            xi = c[k] * xi - s[k] * lik;
+            row[k] = lik;
+        }
+        const double lii = row[i];
+        double r = 0.0;
+        if (sign > 0.0) {
+            r = std::hypot(lii, xi);
+        } else {
+            const double r2 = (lii - xi) * (lii + xi);
+            if (!(r2 > tolerance * lii * lii)) {
+                return false;
+            }
+            r = std::sqrt(r2);
+        }
+        c[i] = r / lii;
+        s[i] = xi / lii;
+        row[i] = r;
+    }
+    return true;
+}
+
+} // namespace
+
+Matrix cholesky(const Matrix& a, std::size_t threads) {
+    const std::size_t n = a.rows();
+    if (a.cols() != n) {
+        throw std::invalid_argument("cholesky requires a square matrix");
+    }
+    Matrix w = a;
+    std::vector<std::size_t> pivots;
+    factorize(w, /*pivot=*/false, 0.0, threads, pivots);
+    for (std::size_t i = 0; i < n; ++i) {
+        std::fill(w.row(i).begin() + static_cast<std::ptrdiff_t>(i) + 1, w.row(i).end(), 0.0);
+    }
+    return w;
+}
+
+PivotedCholesky pivoted_cholesky(const Matrix& a, double tolerance, std::size_t threads) {
+    const std::size_t n = a.rows();
+    if (a.cols() != n) {
+        throw std::invalid_argument("pivoted_cholesky requires a square matrix");
+    }
+    double max_diagonal = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        max_diagonal = std::max(max_diagonal, a(i, i));
+    }
+    const double round_off = static_cast<double>(n) * std::numeric_limits<double>::epsilon() * max_diagonal;
+    if (tolerance < 0.0) {
+        tolerance = round_off;
+    }
+
+    Matrix w = a;
+    PivotedCholesky result;
+    result.rank = factorize(w, /*pivot=*/true, tolerance, threads, result.pivots);
+    const std::size_t r = result.rank;
+
+    // A positive semi-definite remainder with a diagonal below the tolerance has
+    // every entry below it too (|s_ij| <= sqrt(s_ii s_jj)). Its rows still lack
+    // the update from the columns of the panel the factorization stopped in.
+    const double bound = std::max(tolerance, 64.0 * round_off);
+    const std::size_t begin = r - r % kPanel;
+    for (std::size_t i = r; i < n; ++i) {
+        for (std::size_t c = r; c <= i; ++c) {
+            double s = w(i, c);
+            for (std::size_t k = begin; k < r; ++k) {
+                s -= w(i, k) * w(c, k);
+            }
+            if (c == i ? s < -bound : std::abs(s) > bound) {
+                throw std::invalid_argument("matrix is not positive semi-definite");
+            }
+        }
+    }
+
+    result.factor = Matrix(n, r);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t k = 0; k < std::min(i + 1, r); ++k) {
+            result.factor(result.pivots[i], k) = w(i, k);
+        }
+    }
+    if (r > 0) {
+        result.condition = (w(0, 0) * w(0, 0)) / (w(r - 1, r - 1) * w(r - 1, r - 1));
+    }
+    return result;
+}
+
+void cholesky_update(Matrix& l, std::span<const double> x) {
+    check_rank_one(l, x, "cholesky_update");
+    (void)rank_one(l, x, 1.0);
+}
+
+bool cholesky_downdate(Matrix& l, std::span<const double> x) {
+    check_rank_one(l, x, "cholesky_downdate");
+    Matrix updated = l;
+    if (!rank_one(updated, x, -1.0)) {
+        return false;
+    }
+    l = std::move(updated);
+    return true;
+}
+
+} // namespace linalg
+
+} // namespace risk
@@ -0,0 +1,163 @@
+#include <risk/delta_gamma.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+#include <risk/greeks.hpp>
+#include <risk/instrument.hpp>
+
+namespace risk {
+
+namespace {
+
+// Partial sums per row, as in linalg, so the pass vectorizes deterministically.
+constexpr std::size_t kLanes = 8;
+
+// First batch of hybrid repricing, as a multiple of the tail size.
+constexpr std::size_t kInitialTailMultiple = 2;
+constexpr std::size_t kInitialTailPad = 32;
+
+double taylor_row(const double* linear, const double* quadratic, const double* x, std::size_t n) {
+    double acc[kLanes] = {};
+    const std::size_t full = n - n % kLanes;
+    for (std::size_t j = 0; j < full; j += kLanes) {
+        for (std::size_t l = 0; l < kLanes; ++l) {
+            const double xv = x[j + l];
+            acc[l] += xv * (linear[j + l] + quadratic[j + l] * xv);
+        }
+    }
+    for (std::size_t j = full; j < n; ++j) {
+        acc[j - full] += x[j] * (linear[j] + quadratic[j] * x[j]);
+    }
+    return ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+}
+
+} // namespace
+
+DeltaGammaModel::DeltaGammaModel(const InstrumentSoA& soa, std::size_t factor_count)
+    : linear_(factor_count, 0.0), quadratic_(factor_count, 0.0) {
+    std::vector<bs::BSGreeks> per_contract;
+    std::vector<bs::BSGreeks> per_position;
+    GreeksSummary totals;
+    compute_greeks(soa, per_contract, per_position, totals);
+
+    for (std::size_t i = 0; i < soa.size(); ++i) {
+        const bool option = soa.type[i] == static_cast<std::uint8_t>(InstrumentType::Option);
+        const std::size_t factor = option ? soa.underlying_index[i] : soa.id[i];
+        if (factor >= factor_count) {
+            throw std::out_of_range(option ? "underlying index exceeds shock dimension"
+                                           : "equity id exceeds shock dimension");
+        }
+        // Same spot the revaluation paths shock: current price for equities,
+        // underlying price (falling back to current price) for options.
+        const double spot = option && soa.underlying_price[i] > 0.0 ? soa.underlying_price[i] : soa.current_price[i];
+        linear_[factor] += per_position[i].delta * spot;
+        quadratic_[factor] += 0.5 * per_position[i].gamma * spot * spot;
+    }
+}
+
+double DeltaGammaModel::pnl(const double* shocks_row) const {
+    if (shocks_row == nullptr) {
+        throw std::invalid_argument("shocks_row must not be null");
+    }
+    return taylor_row(linear_.data(), quadratic_.data(), shocks_row, linear_.size());
+}
+
+void DeltaGammaModel::pnl(std::span<const double> shocks_flat, std::size_t rows, std::span<double> out) const {
+    const std::size_t cols = linear_.size();
+    if (shocks_flat.size() != rows * cols) {
+        throw std::invalid_argument("shock matrix size mismatch in delta-gamma pnl");
+    }
+    if (out.size() != rows) {
+        throw std::invalid_argument("delta-gamma output size mismatch");
+    }
+    for (std::size_t t = 0; t < rows; ++t) {
+        out[t] = taylor_row(linear_.data(), quadratic_.data(), shocks_flat.data() + t * cols, cols);
+    }
+}
+
+std::vector<std::size_t> refine_tail(std::vector<double>& pnls,
+                                     std::span<const double> lower,
+                                     std::span<const double> upper,
+                                     double q,
+                                     const RepriceRows& reprice,
+                                     RevaluationStats& stats) {
+    const std::size_t n = pnls.size();
+    if (lower.size() != n || upper.size() != n) {
+        throw std::invalid_argument("refine_tail requires one P&L bound pair per scenario");
+    }
+    if (n == 0) {
+        return {};
+    }
+    const std::size_t k = static_cast<std::size_t>(std::floor(std::clamp(q, 0.0, 1.0) * static_cast<double>(n - 1)));
+
+    // Scenario indices by approximate P&L, ties broken by index.
+    const std::vector<double> approx = pnls;
+    std::vector<std::size_t> order(n);
+    std::iota(order.begin(), order.end(), std::size_t{0});
+    std::sort(order.begin(), order.end(), [&approx](std::size_t a, std::size_t b) {
+        return approx[a] < approx[b] || (approx[a] == approx[b] && a < b);
+    });
+
+    // Repriced scenarios are bounded by their full P&L from then on.
+    std::vector<double> bound(upper.begin(), upper.end());
+    std::vector<bool> repriced(n, false);
+    std::size_t done = 0;
+    double max_error = 0.0;
+    double sum_sq_error = 0.0;
+    std::vector<double> full;
+    auto reprice_batch = [&](std::span<const std::size_t> batch) {
+        full.assign(batch.size(), 0.0);
+        reprice(batch, full);
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            const double error = std::abs(full[i] - approx[batch[i]]);
+            max_error = std::max(max_error, error);
+            sum_sq_error += error * error;
+            pnls[batch[i]] = full[i];
+            bound[batch[i]] = full[i];
+            repriced[batch[i]] = true;
+        }
+        done += batch.size();
+    };
+
+    std::vector<std::size_t> batch(order.begin(),
+                                   order.begin() + static_cast<std::ptrdiff_t>(std::min(
+                                                       n, kInitialTailMultiple * (k + 1) + kInitialTailPad)));
+    std::sort(batch.begin(), batch.end());
+    reprice_batch(batch);
+
+    // The quantile of full P&L is at most the (k + 1)-th smallest bound. Once
+    // everything that can reach it is repriced, the threshold can only fall,
+    // so no scenario left out can reach it either.
+    std::vector<double> sorted = bound;
+    std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(k), sorted.end());
+    const double threshold = sorted[k];
+    batch.clear();
+    for (std::size_t t = 0; t < n; ++t) {
+        // Negated so that NaN bounds keep the scenario.
+        if (!repriced[t] && !(lower[t] > threshold)) {
+            batch.push_back(t);
+        }
+    }
+    if (!batch.empty()) {
+        reprice_batch(batch);
+    }
+
+    stats.full_rows = done;
+    stats.checked_rows = done;
+    stats.max_abs_error = max_error;
+    stats.rms_error = std::sqrt(sum_sq_error / static_cast<double>(done));
+
+    std::vector<std::size_t> tail;
+    tail.reserve(done);
+    for (std::size_t t = 0; t < n; ++t) {
+        if (repriced[t]) {
+            tail.push_back(t);
+        }
+    }
+    return tail;
+}
+
+} // namespace risk
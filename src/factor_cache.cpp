@@ -0,0 +1,267 @@
+#include <risk/factor_cache.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <system_error>
+
+#include <unistd.h>
+
+namespace risk {
+
+namespace {
+
+constexpr char kMagic[8] = {'R', 'I', 'S', 'K', 'F', 'C', 'A', 'C'};
+constexpr std::uint32_t kVersion = 2;
+constexpr std::size_t kAlignment = 64;
+
+struct FileHeader {
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t arrays;
+    std::uint64_t key_hi;
+    std::uint64_t key_lo;
+    std::uint64_t checksum;       // of everything after the header
+    std::uint64_t size;           // of the whole file
+    std::uint64_t shape_checksum; // of the array shapes
+    std::uint64_t reserved;
+};
+static_assert(sizeof(FileHeader) == kAlignment);
+
+struct ArrayHeader {
+    std::uint64_t rows;
+    std::uint64_t cols;
+    std::uint64_t offset;
+};
+
+constexpr std::size_t align_up(std::size_t n) {
+    return (n + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+std::uint64_t finalize(std::uint64_t x) noexcept {
+    x ^= x >> 30U;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27U;
+    x *= 0x94D049BB133111EBULL;
+    return x ^ (x >> 31U);
+}
+
+// Checksum of a byte range whose length is a multiple of 8.
+std::uint64_t checksum(std::span<const std::byte> bytes) {
+    CacheKeyBuilder builder;
+    for (std::size_t i = 0; i < bytes.size(); i += sizeof(double)) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, bytes.data() + i, sizeof(word));
+        builder.add(word);
+    }
+    return builder.key().lo;
+}
+
+} // namespace
+
+std::string CacheKey::hex() const {
+    constexpr char kDigits[] = "0123456789abcdef";
+    std::string text(32, '0');
+    for (std::size_t i = 0; i < 16; ++i) {
+        text[15 - i] = kDigits[(hi >> (4 * i)) & 0xFU];
+        text[31 - i] = kDigits[(lo >> (4 * i)) & 0xFU];
+    }
+    return text;
+}
+
+void CacheKeyBuilder::mix(std::uint64_t word) noexcept {
+    a_ = std::rotl((a_ ^ word) * 0x9E3779B97F4A7C15ULL, 29);
+    b_ = std::rotl((b_ + word) * 0xC2B2AE3D27D4EB4FULL, 31) ^ a_;
+    ++words_;
+}
+
+CacheKeyBuilder& CacheKeyBuilder::add(std::string_view text) {
+    mix(text.size());
+    for (std::size_t i = 0; i < text.size(); i += sizeof(std::uint64_t)) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, text.data() + i, std::min(sizeof(word), text.size() - i));
+        mix(word);
+    }
+    return *this;
+}
+
+CacheKeyBuilder& CacheKeyBuilder::add(std::uint64_t value) {
+    mix(value);
+    return *this;
+}
+
+CacheKeyBuilder& CacheKeyBuilder::add(double value) {
+    mix(std::bit_cast<std::uint64_t>(value));
+    return *this;
+}
+
+CacheKeyBuilder& CacheKeyBuilder::add(std::span<const double> values) {
+    mix(values.size());
+    for (double v : values) {
+        mix(std::bit_cast<std::uint64_t>(v));
+    }
+    return *this;
+}
+
+CacheKey CacheKeyBuilder::key() const {
+    return CacheKey{finalize(a_ ^ words_), finalize(b_ + words_ * 0x9E3779B97F4A7C15ULL)};
+}
+
+FactorCache::FactorCache(std::string directory, std::uintmax_t max_bytes)
+    : directory_(std::move(directory)), max_bytes_(max_bytes) {
+    if (directory_.empty()) {
+        throw std::invalid_argument("factor cache directory must not be empty");
+    }
+}
+
+std::string FactorCache::entry_path(const CacheKey& key) const {
+    return (std::filesystem::path(directory_) / (key.hex() + ".rfc")).string();
+}
+
+std::optional<CacheEntry> FactorCache::load(const CacheKey& key, CacheCheck check) const {
+    const std::string path = entry_path(key);
+    std::error_code ec;
+    if (!std::filesystem::is_regular_file(path, ec)) {
+        return std::nullopt;
+    }
+    CacheEntry entry;
+    try {
+        entry.file_ = MappedFile(path);
+    } catch (const std::runtime_error&) {
+        return std::nullopt;
+    }
+
+    const std::span<const std::byte> bytes = entry.file_.bytes();
+    if (bytes.size() < sizeof(FileHeader)) {
+        return std::nullopt;
+    }
+    FileHeader header{};
+    std::memcpy(&header, bytes.data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kVersion ||
+        header.key_hi != key.hi || header.key_lo != key.lo || header.size != bytes.size() ||
+        sizeof(FileHeader) + header.arrays * sizeof(ArrayHeader) > bytes.size()) {
+        return std::nullopt;
+    }
+    if (checksum(bytes.subspan(sizeof(FileHeader), header.arrays * sizeof(ArrayHeader))) != header.shape_checksum) {
+        return std::nullopt;
+    }
+    if (check == CacheCheck::Full && checksum(bytes.subspan(sizeof(FileHeader))) != header.checksum) {
+        return std::nullopt;
+    }
+
+    for (std::size_t i = 0; i < header.arrays; ++i) {
+        ArrayHeader array{};
+        std::memcpy(&array, bytes.data() + sizeof(FileHeader) + i * sizeof(ArrayHeader), sizeof(array));
+        const std::uint64_t count = array.rows * array.cols;
+        if ((array.cols != 0 && count / array.cols != array.rows) || array.offset % kAlignment != 0 ||
+            array.offset > bytes.size() || count > (bytes.size() - array.offset) / sizeof(double)) {
+            return std::nullopt;
+        }
+        const auto* values = reinterpret_cast<const double*>(bytes.data() + array.offset);
+        entry.arrays_.push_back(CacheArray{array.rows, array.cols, {values, static_cast<std::size_t>(count)}});
+    }
+
+    // Marks the entry as recently used for eviction.
+    std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+    return entry;
+}
+
+bool FactorCache::store(const CacheKey& key, std::span<const CacheArray> arrays) const {
+    static std::atomic<std::uint64_t> sequence{0};
+    const std::string path = entry_path(key);
+    const std::string temporary =
+        path + ".tmp." + std::to_string(::getpid()) + "." + std::to_string(sequence.fetch_add(1));
+
+    try {
+        std::filesystem::create_directories(directory_);
+
+        // Layout: header, array shapes, then each array at an aligned offset.
+        std::vector<ArrayHeader> shapes(arrays.size());
+        std::size_t offset = align_up(sizeof(FileHeader) + arrays.size() * sizeof(ArrayHeader));
+        for (std::size_t i = 0; i < arrays.size(); ++i) {
+            if (arrays[i].values.size() != arrays[i].rows * arrays[i].cols) {
+                throw std::invalid_argument("cache array shape does not match its values");
+            }
+            shapes[i] = ArrayHeader{arrays[i].rows, arrays[i].cols, offset};
+            offset = align_up(offset + arrays[i].values.size_bytes());
+        }
+
+        std::vector<std::byte> body(offset - sizeof(FileHeader), std::byte{0});
+        std::memcpy(body.data(), shapes.data(), shapes.size() * sizeof(ArrayHeader));
+        for (std::size_t i = 0; i < arrays.size(); ++i) {
+            std::memcpy(body.data() + (shapes[i].offset - sizeof(FileHeader)),
+                        arrays[i].values.data(),
+                        arrays[i].values.size_bytes());
+        }
+
+        FileHeader header{};
+        std::memcpy(header.magic, kMagic, sizeof(kMagic));
+        header.version = kVersion;
+        header.arrays = static_cast<std::uint32_t>(arrays.size());
+        header.key_hi = key.hi;
+        header.key_lo = key.lo;
+        header.checksum = checksum(body);
+        header.size = offset;
+        header.shape_checksum =
+            checksum(std::span<const std::byte>(body.data(), shapes.size() * sizeof(ArrayHeader)));
+
+        {
+            std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+            out.write(reinterpret_cast<const char*>(body.data()), static_cast<std::streamsize>(body.size()));
+            out.flush();
+            if (!out) {
+                throw std::runtime_error("cache write failed");
+            }
+        }
+        std::filesystem::rename(temporary, path);
+    } catch (const std::exception&) {
+        std::error_code ec;
+        std::filesystem::remove(temporary, ec);
+        return false;
+    }
+    if (max_bytes_ > 0) {
+        evict(path);
+    }
+    return true;
+}
+
+void FactorCache::evict(const std::string& keep) const {
+    struct Entry {
+        std::filesystem::file_time_type used;
+        std::uintmax_t size;
+        std::filesystem::path path;
+    };
+    std::vector<Entry> entries;
+    std::uintmax_t total = 0;
+    std::error_code ec;
+    for (std::filesystem::directory_iterator it(directory_, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->path().extension() != ".rfc" || !it->is_regular_file(ec)) {
+            continue;
+        }
+        Entry entry{it->last_write_time(ec), it->file_size(ec), it->path()};
+        if (!ec) {
+            total += entry.size;
+            entries.push_back(std::move(entry));
+        }
+    }
+
+    // Oldest first; a concurrent run may already have removed some.
+    std::sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) { return a.used < b.used; });
+    for (const Entry& entry : entries) {
+        if (total <= max_bytes_) {
+            break;
+        }
+        if (entry.path.string() == keep) {
+            continue;
+        }
+        std::filesystem::remove(entry.path, ec);
+        total -= entry.size;
+    }
+}
+
+} // namespace risk
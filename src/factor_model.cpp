@@ -0,0 +1,48 @@
+#include <risk/factor_model.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace risk {
+
+FactorModel pca_factor_model(const linalg::Matrix& cov, std::size_t factors) {
+    const std::size_t n = cov.rows();
+    if (cov.cols() != n) {
+        throw std::invalid_argument("covariance matrix must be square");
+    }
+    if (factors == 0 || factors > n) {
+        throw std::invalid_argument("factor count must be in [1, covariance order]");
+    }
+
+    const linalg::SymmetricEigen eigen = linalg::symmetric_eigen(cov, factors);
+
+    FactorModel model;
+    model.loadings_t = linalg::Matrix(factors, n);
+    double kept = 0.0;
+    for (std::size_t j = 0; j < factors; ++j) {
+        const double value = std::max(eigen.values[j], 0.0);
+        kept += value;
+        const double scale = std::sqrt(value);
+        const auto vector = eigen.vectors.row(j);
+        auto loading = model.loadings_t.row(j);
+        for (std::size_t i = 0; i < n; ++i) {
+            loading[i] = scale * vector[i];
+        }
+    }
+
+    double trace = 0.0;
+    model.specific.assign(n, 0.0);
+    for (std::size_t i = 0; i < n; ++i) {
+        trace += cov(i, i);
+        double explained = 0.0;
+        for (std::size_t j = 0; j < factors; ++j) {
+            explained += model.loadings_t(j, i) * model.loadings_t(j, i);
+        }
+        model.specific[i] = std::sqrt(std::max(cov(i, i) - explained, 0.0));
+    }
+    model.explained_variance = trace > 0.0 ? std::min(kept / trace, 1.0) : 1.0;
+    return model;
+}
+
+} // namespace risk
@@ -0,0 +1,46 @@
+#include <risk/gaussian.hpp>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace risk {
+
+namespace rng {
+
+namespace {
+
+constexpr std::size_t kBlock = 256;
+
+} // namespace
+
+void normal_quantile(std::span<const double> u, std::span<double> out) {
+    if (u.size() != out.size()) {
+        throw std::invalid_argument("normal_quantile output span must match input size");
+    }
+    alignas(64) double p[kBlock];
+    alignas(64) double q[kBlock];
+    const std::size_t n = u.size();
+    for (std::size_t base = 0; base < n; base += kBlock) {
+        const std::size_t m = std::min(kBlock, n - base);
+        const double* ub = u.data() + base;
+        double* ob = out.data() + base;
+
+        // Copied first so out may alias u.
+        for (std::size_t i = 0; i < m; ++i) {
+            p[i] = ub[i];
+            q[i] = p[i] - 0.5;
+        }
+        for (std::size_t i = 0; i < m; ++i) {
+            ob[i] = detail::quantile_central(q[i]);
+        }
+        for (std::size_t i = 0; i < m; ++i) {
+            if ((q[i] < 0.0 ? -q[i] : q[i]) > detail::kCentralLimit) {
+                ob[i] = detail::quantile_tail(p[i], q[i]);
+            }
+        }
+    }
+}
+
+} // namespace rng
+
+} // namespace risk
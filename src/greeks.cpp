@@ -3,51 +3,61 @@
 #include <cmath>
 #include <limits>
 
+#include <risk/partition.hpp>
+
 namespace risk {
 
-void compute_greeks(const InstrumentSoA& instruments,
-                    std::vector<bs::BSGreeks>& per_contract,
-                    std::vector<bs::BSGreeks>& per_position,
-                    GreeksSummary& totals,
-                    double spot_override) {
-    const std::size_t n = instruments.size();
-    per_contract.resize(n);
-    per_position.resize(n);
+namespace {
 
-    totals = GreeksSummary{};
+double option_spot(const InstrumentSoA& part, std::size_t k, double spot_override) {
+    if (!std::isnan(spot_override)) {
+        return spot_override;
+    }
+    return part.underlying_price[k] > 0.0 ? part.underlying_price[k] : part.current_price[k];
+}
 
-    for (std::size_t i = 0; i < n; ++i) {
-        const double qty = instruments.qty[i];
-        bs::BSGreeks g{};
-
-        if (instruments.type[i] == static_cast<std::uint8_t>(InstrumentType::Option)) {
-            const double spot = std::isnan(spot_override)
-                                     ? (instruments.underlying_price[i] > 0.0 ? instruments.underlying_price[i]
-                                                                            : instruments.current_price[i])
-                                     : spot_override;
-            if (instruments.is_call[i] != 0) {
-                g = bs::call(spot,
-                             instruments.strike[i],
-                             instruments.rate[i],
-                             instruments.implied_vol[i],
-                             instruments.time_to_maturity[i]);
-            } else {
-                g = bs::put(spot,
-                            instruments.strike[i],
-                            instruments.rate[i],
-                            instruments.implied_vol[i],
-                            instruments.time_to_maturity[i]);
-            }
-        } else { // Equity treated as delta-one
-            g.price = instruments.current_price[i];
-            g.delta = 1.0;
-            g.gamma = 0.0;
-            g.vega = 0.0;
-            g.theta = 0.0;
-            g.rho = 0.0;
-        }
-
-        per_contract[i] = g;
+// Per-contract greeks for row k of a single-kind partition.
+template <class Kind>
+bs::BSGreeks contract_greeks(const InstrumentSoA& part, std::size_t k, double spot_override);
+
+template <>
+bs::BSGreeks contract_greeks<kind::Equity>(const InstrumentSoA& part, std::size_t k, double) {
+    // Equity treated as delta-one
+    bs::BSGreeks g{};
+    g.price = part.current_price[k];
+    g.delta = 1.0;
+    return g;
+}
+
+template <>
+bs::BSGreeks contract_greeks<kind::Call>(const InstrumentSoA& part, std::size_t k, double spot_override) {
+    return bs::call(option_spot(part, k, spot_override),
+                    part.strike[k],
+                    part.rate[k],
+                    part.implied_vol[k],
+                    part.time_to_maturity[k]);
+}
+
+template <>
+bs::BSGreeks contract_greeks<kind::Put>(const InstrumentSoA& part, std::size_t k, double spot_override) {
+    return bs::put(option_spot(part, k, spot_override),
+                   part.strike[k],
+                   part.rate[k],
+                   part.implied_vol[k],
+                   part.time_to_maturity[k]);
+}
+
+// Writes one partition's greeks back to the positions they came from.
+template <class Kind>
+void fill_greeks(const InstrumentSoA& part,
+                 const std::vector<std::size_t>& index,
+                 std::vector<bs::BSGreeks>& per_contract,
+                 std::vector<bs::BSGreeks>& per_position,
+                 double spot_override) {
+    const std::size_t n = part.size();
+    for (std::size_t k = 0; k < n; ++k) {
+        const bs::BSGreeks g = contract_greeks<Kind>(part, k, spot_override);
+        const double qty = part.qty[k];
 
         bs::BSGreeks pos = g;
         pos.price *= qty;
@@ -57,14 +67,36 @@ void compute_greeks(const InstrumentSoA& instruments,
         pos.theta *= qty;
         pos.rho *= qty;
 
+        per_contract[index[k]] = g;
+        per_position[index[k]] = pos;
+    }
+}
+
+} // namespace
+
+void compute_greeks(const InstrumentSoA& instruments,
+                    std::vector<bs::BSGreeks>& per_contract,
+                    std::vector<bs::BSGreeks>& per_position,
+                    GreeksSummary& totals,
+                    double spot_override) {
+    const std::size_t n = instruments.size();
+    per_contract.resize(n);
+    per_position.resize(n);
+
+    const PartitionedSoA parts = partition_by_kind(instruments);
+    fill_greeks<kind::Equity>(parts.equities, parts.equity_index, per_contract, per_position, spot_override);
+    fill_greeks<kind::Call>(parts.calls, parts.call_index, per_contract, per_position, spot_override);
+    fill_greeks<kind::Put>(parts.puts, parts.put_index, per_contract, per_position, spot_override);
+
+    // Accumulate in portfolio order so totals do not depend on the partitioning.
+    totals = GreeksSummary{};
+    for (const bs::BSGreeks& pos : per_position) {
         totals.price += pos.price;
         totals.delta += pos.delta;
         totals.gamma += pos.gamma;
         totals.vega += pos.vega;
         totals.theta += pos.theta;
         totals.rho += pos.rho;
-
-        per_position[i] = pos;
     }
 }
 
@@ -1,5 +1,7 @@
 #include <risk/instrument_soa.hpp>
 
+#include <stdexcept>
+
 namespace risk {
 
 void InstrumentSoA::reserve(std::size_t n) {
@@ -41,4 +43,50 @@ InstrumentSoA to_struct_of_arrays(const std::vector<Instrument>& instruments) {
     return soa;
 }
 
+void append_instrument(InstrumentSoA& dst, const InstrumentSoA& src, std::size_t index) {
+    dst.id.push_back(src.id[index]);
+    dst.type.push_back(src.type[index]);
+    dst.is_call.push_back(src.is_call[index]);
+    dst.qty.push_back(src.qty[index]);
+    dst.current_price.push_back(src.current_price[index]);
+    dst.underlying_price.push_back(src.underlying_price[index]);
+    dst.underlying_index.push_back(src.underlying_index[index]);
+    dst.strike.push_back(src.strike[index]);
+    dst.time_to_maturity.push_back(src.time_to_maturity[index]);
+    dst.implied_vol.push_back(src.implied_vol[index]);
+    dst.rate.push_back(src.rate[index]);
+}
+
+FactorSubset referenced_factors(const InstrumentSoA& soa, std::size_t factor_count) {
+    const auto option = static_cast<std::uint8_t>(InstrumentType::Option);
+    constexpr std::uint32_t kUnused = ~std::uint32_t{0};
+    std::vector<std::uint32_t> slot(factor_count, kUnused);
+    for (std::size_t i = 0; i < soa.size(); ++i) {
+        const bool is_option = soa.type[i] == option;
+        const std::uint32_t factor = is_option ? soa.underlying_index[i] : soa.id[i];
+        if (factor >= factor_count) {
+            throw std::out_of_range(is_option ? "underlying index exceeds shock dimension"
+                                              : "equity id exceeds shock dimension");
+        }
+        slot[factor] = 0;
+    }
+
+    FactorSubset subset;
+    for (std::size_t f = 0; f < factor_count; ++f) {
+        if (slot[f] != kUnused) {
+            slot[f] = static_cast<std::uint32_t>(subset.factors.size());
+            subset.factors.push_back(static_cast<std::uint32_t>(f));
+        }
+    }
+    subset.soa = soa;
+    for (std::size_t i = 0; i < soa.size(); ++i) {
+        if (soa.type[i] == option) {
+            subset.soa.underlying_index[i] = slot[soa.underlying_index[i]];
+        } else {
+            subset.soa.id[i] = slot[soa.id[i]];
+        }
+    }
+    return subset;
+}
+
 } // namespace risk
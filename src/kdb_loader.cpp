@@ -347,9 +347,7 @@ Eigen::VectorXd load_sample_mean(int handle, std::size_t expected_factors) {
     if (result->t == 9) {
         enforce_condition(static_cast<std::size_t>(result->n) == expected_factors, "Mean vector length mismatch");
         const double* values = kF(result);
-        for (std::size_t i = 0; i < expected_factors; ++i) {
-            mean(static_cast<Eigen::Index>(i)) = values[i];
-        }
+        std::copy(values, values + expected_factors, mean.data());
         return mean;
     }
 
@@ -386,9 +384,7 @@ Eigen::MatrixXd load_sample_covariance(int handle, std::size_t expected_factors)
             enforce_condition(static_cast<std::size_t>(row_vector->n) == expected_factors,
                               "Covariance column count mismatch");
             const double* values = kF(row_vector);
-            for (std::size_t col = 0; col < expected_factors; ++col) {
-                covariance(static_cast<Eigen::Index>(row), static_cast<Eigen::Index>(col)) = values[col];
-            }
+            std::copy(values, values + expected_factors, covariance.row(static_cast<Eigen::Index>(row)).begin());
             continue;
         }
         if (row_vector->t == 0) {
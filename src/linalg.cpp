@@ -0,0 +1,499 @@
+#include <risk/linalg.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+
+namespace risk {
+
+namespace linalg {
+
+namespace {
+
+// Partial sums per reduction: one AVX-512 register, or two AVX2 registers.
+constexpr std::size_t kLanes = 8;
+
+// Rows of A sharing each load of x in gemv.
+constexpr std::size_t kRowBlock = 4;
+
+// gemm blocking: a kKc × kNc panel of B (256 KiB) stays in L2 while kMr rows of
+// A stream through it; the kMr × kNr tile of C lives in registers.
+constexpr std::size_t kKc = 256;
+constexpr std::size_t kNc = 128;
+constexpr std::size_t kMr = 4;
+constexpr std::size_t kNr = 16;
+
+double sum_lanes(const double (&acc)[kLanes]) {
+    return ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+}
+
+double dot_unchecked(const double* x, const double* y, std::size_t n) {
+    double acc[kLanes] = {};
+    const std::size_t full = n - n % kLanes;
+    for (std::size_t j = 0; j < full; j += kLanes) {
+        for (std::size_t l = 0; l < kLanes; ++l) {
+            acc[l] += x[j + l] * y[j + l];
+        }
+    }
+    for (std::size_t j = full; j < n; ++j) {
+        acc[j - full] += x[j] * y[j];
+    }
+    return sum_lanes(acc);
+}
+
+// C tile += A rows × B panel, rows × cols of C at most kMr × kNr. The full tile
+// is a constant-trip loop nest the compiler keeps in vector registers; edge
+// tiles run the same statements with runtime bounds.
+void gemm_edge_tile(const double* a, std::size_t lda,
+                    const double* b, std::size_t ldb,
+                    double* c, std::size_t ldc,
+                    std::size_t kc, std::size_t rows, std::size_t cols) {
+    double acc[kMr][kNr];
+    for (std::size_t i = 0; i < rows; ++i) {
+        for (std::size_t j = 0; j < cols; ++j) {
+            acc[i][j] = c[i * ldc + j];
+        }
+    }
+    for (std::size_t p = 0; p < kc; ++p) {
+        const double* bp = b + p * ldb;
+        for (std::size_t i = 0; i < rows; ++i) {
+            const double ai = a[i * lda + p];
+            for (std::size_t j = 0; j < cols; ++j) {
+                acc[i][j] += ai * bp[j];
+            }
+        }
+    }
+    for (std::size_t i = 0; i < rows; ++i) {
+        for (std::size_t j = 0; j < cols; ++j) {
+            c[i * ldc + j] = acc[i][j];
+        }
+    }
+}
+
+void gemm_full_tile(const double* a, std::size_t lda,
+                    const double* b, std::size_t ldb,
+                    double* c, std::size_t ldc,
+                    std::size_t kc) {
+    double acc[kMr][kNr];
+#pragma GCC unroll 4
+    for (std::size_t i = 0; i < kMr; ++i) {
+#pragma GCC unroll 16
+        for (std::size_t j = 0; j < kNr; ++j) {
+            acc[i][j] = c[i * ldc + j];
+        }
+    }
+    for (std::size_t p = 0; p < kc; ++p) {
+        const double* bp = b + p * ldb;
+#pragma GCC unroll 4
+        for (std::size_t i = 0; i < kMr; ++i) {
+            const double ai = a[i * lda + p];
+#pragma GCC unroll 16
+            for (std::size_t j = 0; j < kNr; ++j) {
+                acc[i][j] += ai * bp[j];
+            }
+        }
+    }
+#pragma GCC unroll 4
+    for (std::size_t i = 0; i < kMr; ++i) {
+#pragma GCC unroll 16
+        for (std::size_t j = 0; j < kNr; ++j) {
+            c[i * ldc + j] = acc[i][j];
+        }
+    }
+}
+
+// Householder reduction of the symmetric n × n matrix in a (upper triangle used)
+// to tridiagonal T = Q^T A Q, with diagonal d and subdiagonal e[0..n-2]. Step j
+// reflects indices j + 1.. by I - beta[j] v v^T and leaves v in row j of a from
+// column j + 1 on, where the column it annihilates used to be.
+void tridiagonalize(double* a, std::size_t n, std::vector<double>& d, std::vector<double>& e, std::vector<double>& beta) {
+    d.assign(n, 0.0);
+    e.assign(n, 0.0);
+    beta.assign(n, 0.0);
+    std::vector<double> p(n);
+    for (std::size_t j = 0; j + 2 < n; ++j) {
+        const std::size_t s = j + 1;
+        const std::size_t m = n - s;
+        double* v = a + j * n + s;
+        d[j] = a[j * n + j];
+        const double norm_sq = dot_unchecked(v, v, m);
+        if (norm_sq == 0.0) {
+            continue;
+        }
+        const double alpha = v[0] > 0.0 ? -std::sqrt(norm_sq) : std::sqrt(norm_sq);
+        e[j] = alpha;
+        const double b = 1.0 / (norm_sq - alpha * v[0]);
+        v[0] -= alpha;
+        beta[j] = b;
+
+        // p = beta A22 v from the upper triangle of the trailing block, row by row.
+        std::fill(p.begin(), p.begin() + static_cast<std::ptrdiff_t>(m), 0.0);
+        for (std::size_t r = 0; r < m; ++r) {
+            const double* row = a + (s + r) * n + s + r;
+            p[r] += dot_unchecked(row, v + r, m - r);
+            const double vr = v[r];
+            for (std::size_t c = 1; c < m - r; ++c) {
+                p[r + c] += vr * row[c];
+            }
+        }
+        for (std::size_t r = 0; r < m; ++r) {
+            p[r] *= b;
+        }
+        // A22 -= v w^T + w v^T with w = p - (beta p.v / 2) v.
+        const double k = 0.5 * b * dot_unchecked(p.data(), v, m);
+        for (std::size_t r = 0; r < m; ++r) {
+            p[r] -= k * v[r];
+        }
+        for (std::size_t r = 0; r < m; ++r) {
+            double* row = a + (s + r) * n + s + r;
+            const double vr = v[r];
+            const double wr = p[r];
+            for (std::size_t c = 0; c < m - r; ++c) {
+                row[c] -= vr * p[r + c] + wr * v[r + c];
+            }
+        }
+    }
+    if (n >= 2) {
+        d[n - 2] = a[(n - 2) * n + n - 2];
+        e[n - 2] = a[(n - 2) * n + n - 1];
+    }
+    d[n - 1] = a[(n - 1) * n + n - 1];
+}
+
+// Eigenvalues of the symmetric tridiagonal matrix (d, e) by implicit QL with
+// Wilkinson shifts (tql1 of EISPACK), overwriting d; e is destroyed.
+void tridiagonal_eigenvalues(std::vector<double>& d, std::vector<double>& e) {
+    constexpr int kMaxIterations = 64;
+    const double eps = std::numeric_limits<double>::epsilon();
+    const std::size_t n = d.size();
+    double shift = 0.0;
+    double tst1 = 0.0;
+    for (std::size_t l = 0; l < n; ++l) {
+        tst1 = std::max(tst1, std::abs(d[l]) + std::abs(e[l]));
+        std::size_t m = l;
+        while (m + 1 < n && std::abs(e[m]) > eps * tst1) {
+            ++m;
+        }
+        for (int iteration = 0; m > l && std::abs(e[l]) > eps * tst1; ++iteration) {
+            if (iteration == kMaxIterations) {
+                throw std::runtime_error("symmetric eigenvalue iteration failed to converge");
+            }
+            const double g = d[l];
+            double p = (d[l + 1] - g) / (2.0 * e[l]);
+            double r = std::hypot(p, 1.0);
+            if (p < 0.0) {
+                r = -r;
+            }
+            d[l] = e[l] / (p + r);
+            d[l + 1] = e[l] * (p + r);
+            const double dl1 = d[l + 1];
+            double h = g - d[l];
+            for (std::size_t i = l + 2; i < n; ++i) {
+                d[i] -= h;
+            }
+            shift += h;
+
+            p = d[m];
+            double c = 1.0;
+            double c2 = 1.0;
+            double c3 = 1.0;
+            const double el1 = e[l + 1];
+            double s = 0.0;
+            double s2 = 0.0;
+            for (std::size_t i = m; i-- > l;) {
+                c3 = c2;
+                c2 = c;
+                s2 = s;
+                const double ge = c * e[i];
+                h = c * p;
+                r = std::hypot(p, e[i]);
+                e[i + 1] = s * r;
+                s = e[i] / r;
+                c = p / r;
+                p = c * d[i] - s * ge;
+                d[i + 1] = h + s * (c * ge + s * d[i]);
+            }
+            p = -s * s2 * c3 * el1 * e[l] / dl1;
+            e[l] = s * p;
+            d[l] = c * p;
+        }
+        d[l] += shift;
+        e[l] = 0.0;
+    }
+}
+
+// Solves (T - lambda I) x = x in place for the tridiagonal T = (d, e) by
+// Gaussian elimination with partial pivoting (LAPACK dgttrf/dgttrs). Pivots
+// below `tiny` are raised to it, which is what makes a solve at an eigenvalue
+// usable for inverse iteration.
+void shifted_tridiagonal_solve(const std::vector<double>& d,
+                               const std::vector<double>& e,
+                               double lambda,
+                               double tiny,
+                               std::vector<double>& x) {
+    const std::size_t n = d.size();
+    std::vector<double> diag(n);
+    std::vector<double> lower(n, 0.0);
+    std::vector<double> upper(n, 0.0);
+    std::vector<double> upper2(n, 0.0);
+    std::vector<bool> swapped(n, false);
+    for (std::size_t i = 0; i < n; ++i) {
+        diag[i] = d[i] - lambda;
+        lower[i] = e[i];
+        upper[i] = e[i];
+    }
+    for (std::size_t i = 0; i + 1 < n; ++i) {
+        if (std::abs(diag[i]) >= std::abs(lower[i])) {
+            if (diag[i] != 0.0) {
+                const double factor = lower[i] / diag[i];
+                lower[i] = factor;
+                diag[i + 1] -= factor * upper[i];
+            }
+        } else {
+            const double factor = diag[i] / lower[i];
+            diag[i] = lower[i];
+            lower[i] = factor;
+            const double temp = upper[i];
+            upper[i] = diag[i + 1];
+            diag[i + 1] = temp - factor * diag[i + 1];
+            if (i + 2 < n) {
+                upper2[i] = upper[i + 1];
+                upper[i + 1] = -factor * upper[i + 1];
+            }
+            swapped[i] = true;
+        }
+    }
+    for (double& pivot : diag) {
+        if (std::abs(pivot) < tiny) {
+            pivot = pivot < 0.0 ? -tiny : tiny;
+        }
+    }
+
+    for (std::size_t i = 0; i + 1 < n; ++i) {
+        if (swapped[i]) {
+            const double temp = x[i];
+            x[i] = x[i + 1];
+            x[i + 1] = temp - lower[i] * x[i];
+        } else {
+            x[i + 1] -= lower[i] * x[i];
+        }
+    }
+    for (std::size_t i = n; i-- > 0;) {
+        double value = x[i];
+        if (i + 1 < n) {
+            value -= upper[i] * x[i + 1];
+        }
+        if (i + 2 < n) {
+            value -= upper2[i] * x[i + 2];
+        }
+        x[i] = value / diag[i];
+    }
+}
+
+void normalize(std::vector<double>& x) {
+    const double norm = std::sqrt(dot_unchecked(x.data(), x.data(), x.size()));
+    for (double& v : x) {
+        v /= norm;
+    }
+}
+
+} // namespace
+
+Matrix Matrix::transposed() const {
+    Matrix t(cols_, rows_);
+    for (std::size_t r = 0; r < rows_; ++r) {
+        for (std::size_t c = 0; c < cols_; ++c) {
+            t(c, r) = (*this)(r, c);
+        }
+    }
+    return t;
+}
+
+void gemm_strided(const double* a,
+                  std::size_t lda,
+                  const double* b,
+                  std::size_t ldb,
+                  double* c,
+                  std::size_t ldc,
+                  std::size_t m,
+                  std::size_t k,
+                  std::size_t n) {
+    for (std::size_t p0 = 0; p0 < k; p0 += kKc) {
+        const std::size_t kc = std::min(kKc, k - p0);
+        for (std::size_t j0 = 0; j0 < n; j0 += kNc) {
+            const std::size_t nc = std::min(kNc, n - j0);
+            for (std::size_t i = 0; i < m; i += kMr) {
+                const std::size_t rows = std::min(kMr, m - i);
+                const double* a_block = a + i * lda + p0;
+                for (std::size_t j = 0; j < nc; j += kNr) {
+                    const std::size_t cols = std::min(kNr, nc - j);
+                    const double* b_block = b + p0 * ldb + j0 + j;
+                    double* c_block = c + i * ldc + j0 + j;
+                    if (rows == kMr && cols == kNr) {
+                        gemm_full_tile(a_block, lda, b_block, ldb, c_block, ldc, kc);
+                    } else {
+                        gemm_edge_tile(a_block, lda, b_block, ldb, c_block, ldc, kc, rows, cols);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void gemm(std::span<const double> a,
+          std::size_t m,
+          std::size_t k,
+          std::span<const double> b,
+          std::size_t n,
+          std::span<double> c) {
+    if (a.size() != m * k || b.size() != k * n || c.size() != m * n) {
+        throw std::invalid_argument("gemm matrix size mismatch");
+    }
+    gemm_strided(a.data(), k, b.data(), n, c.data(), n, m, k, n);
+}
+
+void gemm(const Matrix& a, const Matrix& b, Matrix& c) {
+    if (a.cols() != b.rows() || c.rows() != a.rows() || c.cols() != b.cols()) {
+        throw std::invalid_argument("gemm matrix dimension mismatch");
+    }
+    gemm(a.values(), a.rows(), a.cols(), b.values(), b.cols(), c.values());
+}
+
+double dot(std::span<const double> x, std::span<const double> y) {
+    if (x.size() != y.size()) {
+        throw std::invalid_argument("dot requires vectors of equal length");
+    }
+    return dot_unchecked(x.data(), y.data(), x.size());
+}
+
+void gemv(std::span<const double> a,
+          std::size_t rows,
+          std::size_t cols,
+          std::span<const double> x,
+          std::span<double> y) {
+    if (a.size() != rows * cols) {
+        throw std::invalid_argument("gemv matrix size mismatch");
+    }
+    if (x.size() != cols || y.size() != rows) {
+        throw std::invalid_argument("gemv vector size mismatch");
+    }
+
+    const std::size_t full_cols = cols - cols % kLanes;
+    std::size_t r = 0;
+    for (; r + kRowBlock <= rows; r += kRowBlock) {
+        const double* row0 = a.data() + r * cols;
+        const double* row1 = row0 + cols;
+        const double* row2 = row1 + cols;
+        const double* row3 = row2 + cols;
+        double acc0[kLanes] = {};
+        double acc1[kLanes] = {};
+        double acc2[kLanes] = {};
+        double acc3[kLanes] = {};
+        for (std::size_t j = 0; j < full_cols; j += kLanes) {
+            for (std::size_t l = 0; l < kLanes; ++l) {
+                const double xv = x[j + l];
+                acc0[l] += row0[j + l] * xv;
+                acc1[l] += row1[j + l] * xv;
+                acc2[l] += row2[j + l] * xv;
+                acc3[l] += row3[j + l] * xv;
+            }
+        }
+        for (std::size_t j = full_cols; j < cols; ++j) {
+            const double xv = x[j];
+            acc0[j - full_cols] += row0[j] * xv;
+            acc1[j - full_cols] += row1[j] * xv;
+            acc2[j - full_cols] += row2[j] * xv;
+            acc3[j - full_cols] += row3[j] * xv;
+        }
+        y[r] = sum_lanes(acc0);
+        y[r + 1] = sum_lanes(acc1);
+        y[r + 2] = sum_lanes(acc2);
+        y[r + 3] = sum_lanes(acc3);
+    }
+    for (; r < rows; ++r) {
+        y[r] = dot_unchecked(a.data() + r * cols, x.data(), cols);
+    }
+}
+
+SymmetricEigen symmetric_eigen(const Matrix& a, std::size_t count) {
+    const std::size_t n = a.rows();
+    if (a.cols() != n) {
+        throw std::invalid_argument("symmetric_eigen requires a square matrix");
+    }
+    if (count > n) {
+        throw std::invalid_argument("symmetric_eigen count exceeds the matrix order");
+    }
+    SymmetricEigen result;
+    result.vectors = Matrix(count, n);
+    if (count == 0) {
+        return result;
+    }
+
+    Matrix work = a;
+    std::vector<double> d;
+    std::vector<double> e;
+    std::vector<double> beta;
+    tridiagonalize(work.values().data(), n, d, e, beta);
+
+    std::vector<double> values = d;
+    std::vector<double> scratch = e;
+    tridiagonal_eigenvalues(values, scratch);
+    std::sort(values.begin(), values.end(), std::greater<>());
+    result.values.assign(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(count));
+
+    double t_norm = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        t_norm = std::max(t_norm, std::abs(d[i]) + std::abs(e[i]) + (i > 0 ? std::abs(e[i - 1]) : 0.0));
+    }
+    const double tiny = std::max(t_norm, std::numeric_limits<double>::min()) * std::numeric_limits<double>::epsilon();
+    // Eigenvalues this close share a cluster; their vectors are kept orthogonal
+    // explicitly, as inverse iteration alone would find the same one.
+    const double cluster = 1e-3 * t_norm;
+
+    constexpr int kInverseIterations = 3;
+    std::vector<double> x(n);
+    for (std::size_t j = 0; j < count; ++j) {
+        const double lambda = result.values[j];
+        for (std::size_t i = 0; i < n; ++i) {
+            x[i] = 1.0 + static_cast<double>((i * 2654435761U + j * 40503U) % 1021U) / 1021.0;
+        }
+        for (int iteration = 0; iteration < kInverseIterations; ++iteration) {
+            shifted_tridiagonal_solve(d, e, lambda, tiny, x);
+            for (std::size_t t = 0; t < j; ++t) {
+                if (std::abs(result.values[t] - lambda) > cluster) {
+                    continue;
+                }
+                const std::span<const double> y = result.vectors.row(t);
+                const double projection = dot_unchecked(x.data(), y.data(), n);
+                for (std::size_t i = 0; i < n; ++i) {
+                    x[i] -= projection * y[i];
+                }
+            }
+            normalize(x);
+        }
+        std::copy(x.begin(), x.end(), result.vectors.row(j).begin());
+    }
+
+    // Eigenvectors of A are Q y = H_0 H_1 ... y; apply the last reflector first.
+    for (std::size_t j = 0; j < count; ++j) {
+        double* u = result.vectors.row(j).data();
+        for (std::size_t r = n >= 2 ? n - 2 : 0; r-- > 0;) {
+            if (beta[r] == 0.0) {
+                continue;
+            }
+            const double* v = work.values().data() + r * n + r + 1;
+            const std::size_t m = n - r - 1;
+            const double scale = beta[r] * dot_unchecked(v, u + r + 1, m);
+            for (std::size_t i = 0; i < m; ++i) {
+                u[r + 1 + i] -= scale * v[i];
+            }
+        }
+    }
+    return result;
+}
+
+} // namespace linalg
+
+} // namespace risk
@@ -1,58 +1,126 @@
 #include <risk/market.hpp>
 
+#include <risk/mapped_file.hpp>
+#include <risk/parallel.hpp>
 #include <risk/universe.hpp>
 
 #include <spdlog/spdlog.h>
 
-#include <cctype>
+#include <algorithm>
+#include <charconv>
 #include <cmath>
-#include <fstream>
-#include <sstream>
+#include <cstring>
+#include <limits>
 #include <stdexcept>
 #include <string>
 #include <string_view>
+#include <system_error>
 #include <vector>
 
 namespace risk {
 
 namespace {
 
-std::string trim(std::string_view input) {
-    const auto begin = input.find_first_not_of(" \t\r\n");
-    if (begin == std::string_view::npos) {
-        return std::string{};
+// Data rows per parallel chunk are found by splitting the bytes evenly and
+// moving each cut past the next newline; below this many bytes one chunk is
+// parsed on the calling thread.
+constexpr std::size_t kChunkBytes = 1 << 16;
+
+bool is_space(char c) {
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+std::string_view trim(std::string_view input) {
+    while (!input.empty() && is_space(input.front())) {
+        input.remove_prefix(1);
     }
-    const auto end = input.find_last_not_of(" \t\r\n");
-    return std::string(input.substr(begin, end - begin + 1));
+    while (!input.empty() && is_space(input.back())) {
+        input.remove_suffix(1);
+    }
+    return input;
 }
 
-std::vector<std::string> split_csv_line(const std::string& line) {
+bool is_blank(std::string_view line) {
+    return trim(line).empty();
+}
+
+std::vector<std::string> split_csv_line(std::string_view line) {
     std::vector<std::string> fields;
-    std::string field;
-    std::istringstream stream(line);
-    while (std::getline(stream, field, ',')) {
-        fields.emplace_back(trim(field));
+    if (line.empty()) {
+        return fields;
     }
-    if (!line.empty() && line.back() == ',') {
-        fields.emplace_back();
+    for (std::size_t begin = 0;;) {
+        const std::size_t comma = line.find(',', begin);
+        fields.emplace_back(trim(line.substr(begin, comma - begin)));
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        begin = comma + 1;
     }
     return fields;
 }
 
-bool parse_double(const std::string& token, double& value) {
+// Accepts what std::stod did for a close: an optional leading '+', decimal or
+// scientific notation, the whole token consumed, finite.
+bool parse_double(std::string_view token, double& value) {
+    if (!token.empty() && token.front() == '+') {
+        token.remove_prefix(1);
+    }
     if (token.empty()) {
         return false;
     }
-    try {
-        size_t idx = 0;
-        value = std::stod(token, &idx);
-        if (idx != token.size() || !std::isfinite(value)) {
-            return false;
+    const auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), value);
+    return error == std::errc{} && end == token.data() + token.size() && std::isfinite(value);
+}
+
+// Next line of [cursor, end), without its newline; advances cursor past it.
+std::string_view next_line(const char*& cursor, const char* end) {
+    const char* newline = static_cast<const char*>(std::memchr(cursor, '\n', static_cast<std::size_t>(end - cursor)));
+    const char* stop = newline != nullptr ? newline : end;
+    const std::string_view line(cursor, static_cast<std::size_t>(stop - cursor));
+    cursor = newline != nullptr ? newline + 1 : end;
+    return line;
+}
+
+// A newline-aligned range of data rows, parsed in two passes: count the rows,
+// then, once every chunk knows its first row, parse them in place.
+struct CsvChunk {
+    const char* begin = nullptr;
+    const char* end = nullptr;
+    std::size_t rows = 0;
+    std::size_t first_row = 0;
+    // First failure in the chunk, by row; rows before it were parsed.
+    std::size_t error_row = std::numeric_limits<std::size_t>::max();
+    bool bad_field_count = false;
+    std::size_t bad_ticker = 0;
+};
+
+void parse_chunk(CsvChunk& chunk, std::size_t N, std::vector<std::string>& dates, std::vector<double>& prices_flat) {
+    std::size_t row = chunk.first_row;
+    for (const char* cursor = chunk.begin; cursor < chunk.end;) {
+        const std::string_view line = next_line(cursor, chunk.end);
+        if (is_blank(line)) {
+            continue;
         }
-    } catch (const std::exception&) {
-        return false;
+        if (static_cast<std::size_t>(std::count(line.begin(), line.end(), ',')) != N) {
+            chunk.error_row = row;
+            chunk.bad_field_count = true;
+            return;
+        }
+        std::size_t comma = line.find(',');
+        dates[row] = std::string(trim(line.substr(0, comma)));
+        double* prices = prices_flat.data() + row * N;
+        for (std::size_t i = 0; i < N; ++i) {
+            const std::size_t begin = comma + 1;
+            comma = line.find(',', begin);
+            if (!parse_double(trim(line.substr(begin, comma - begin)), prices[i]) || prices[i] <= 0.0) {
+                chunk.error_row = row;
+                chunk.bad_ticker = i;
+                return;
+            }
+        }
+        ++row;
     }
-    return true;
 }
 
 } // namespace
@@ -61,25 +129,29 @@ bool load_closes_csv(const std::string& path,
                      std::vector<std::string>& dates,
                      std::vector<double>& prices_flat,
                      std::size_t& T,
-                     std::size_t& N) {
+                     std::size_t& N,
+                     std::size_t threads) {
     dates.clear();
     prices_flat.clear();
     T = 0;
     N = 0;
 
-    std::ifstream input(path);
-    if (!input.is_open()) {
+    MappedFile file;
+    try {
+        file = MappedFile(path);
+    } catch (const std::runtime_error&) {
         spdlog::error("Failed to open closes CSV: {}", path);
         return false;
     }
+    const char* cursor = reinterpret_cast<const char*>(file.bytes().data());
+    const char* const end = cursor + file.bytes().size();
 
-    std::string line;
-    if (!std::getline(input, line)) {
+    if (cursor == end) {
         spdlog::error("Closes CSV missing header row");
         return false;
     }
 
-    const auto header = split_csv_line(line);
+    const auto header = split_csv_line(next_line(cursor, end));
     if (header.size() < 2) {
         spdlog::error("Unexpected column count in closes header");
         return false;
@@ -102,30 +174,57 @@ bool load_closes_csv(const std::string& path,
     risk::set_universe(tickers);
     N = tickers.size();
 
-    std::vector<double> row(N, 0.0);
-    while (std::getline(input, line)) {
-        if (line.find_first_not_of(" \t\r\n") == std::string::npos) {
-            continue;
+    const auto bytes = static_cast<std::size_t>(end - cursor);
+    const std::size_t count = std::max<std::size_t>(1, std::min(bytes / kChunkBytes, 16 * resolve_thread_count(threads)));
+    std::vector<CsvChunk> chunks(count);
+    const char* chunk_begin = cursor;
+    for (std::size_t c = 0; c < count; ++c) {
+        const char* cut = c + 1 == count ? end : cursor + bytes * (c + 1) / count;
+        if (cut < chunk_begin) {
+            cut = chunk_begin;
         }
-        const auto fields = split_csv_line(line);
-        if (fields.size() != N + 1) {
-            spdlog::error("Unexpected field count in closes row");
-            return false;
+        if (cut != end) {
+            const void* newline = std::memchr(cut, '\n', static_cast<std::size_t>(end - cut));
+            cut = newline != nullptr ? static_cast<const char*>(newline) + 1 : end;
         }
+        chunks[c].begin = chunk_begin;
+        chunks[c].end = cut;
+        chunk_begin = cut;
+    }
 
-        dates.emplace_back(fields.front());
-        for (std::size_t i = 0; i < N; ++i) {
-            double value = 0.0;
-            if (!parse_double(fields[i + 1], value) || value <= 0.0) {
-                spdlog::error("Invalid close for ticker '{}'", tickers[i]);
-                return false;
+    parallel_for(count, 1, threads, [&](std::size_t, std::size_t c, std::size_t) {
+        for (const char* line_cursor = chunks[c].begin; line_cursor < chunks[c].end;) {
+            if (!is_blank(next_line(line_cursor, chunks[c].end))) {
+                ++chunks[c].rows;
+            }
+        }
+    });
+    for (std::size_t c = 0; c < count; ++c) {
+        chunks[c].first_row = T;
+        T += chunks[c].rows;
+    }
+
+    dates.resize(T);
+    prices_flat.resize(T * N);
+    parallel_for(count, 1, threads, [&](std::size_t, std::size_t c, std::size_t) {
+        parse_chunk(chunks[c], N, dates, prices_flat);
+    });
+
+    // Chunks are in file order, so the first failing one holds the first bad row.
+    for (const CsvChunk& chunk : chunks) {
+        if (chunk.error_row != std::numeric_limits<std::size_t>::max()) {
+            if (chunk.bad_field_count) {
+                spdlog::error("Unexpected field count in closes row");
+            } else {
+                spdlog::error("Invalid close for ticker '{}'", tickers[chunk.bad_ticker]);
             }
-            row[i] = value;
+            dates.clear();
+            prices_flat.clear();
+            T = 0;
+            return false;
         }
-        prices_flat.insert(prices_flat.end(), row.begin(), row.end());
     }
 
-    T = dates.size();
     if (T == 0) {
         spdlog::error("No data rows found in closes CSV");
         return false;
@@ -1,69 +1,240 @@
 #include <risk/mcvar.hpp>
 
 #include <algorithm>
+#include <chrono>
 #include <cmath>
 #include <cstddef>
-#include <random>
+#include <cstdint>
+#include <limits>
+#include <optional>
 #include <span>
 #include <stdexcept>
+#include <string>
+#include <utility>
 #include <vector>
 
+#include <risk/cholesky.hpp>
+#include <risk/delta_gamma.hpp>
+#include <risk/factor_model.hpp>
+#include <risk/gaussian.hpp>
 #include <risk/hvar.hpp>
+#include <risk/linalg.hpp>
+#include <risk/rng.hpp>
+#include <risk/sobol.hpp>
 #include <risk/universe.hpp>
-#include <risk/utils.hpp>
+#include <risk/vmath.hpp>
 
 namespace risk {
 
 namespace {
 
-std::vector<double> compute_cholesky(std::span<const double> cov, int dim) {
-    if (dim <= 0) {
-        throw std::invalid_argument("covariance dimension must be positive");
+constexpr std::size_t kErrorBatches = 20;
+
+// Part of the path-factor cache key; bump it whenever compute_path_factors or
+// the entry layout changes, so entries written by older builds are not reused.
+constexpr std::uint64_t kPathFactorsVersion = 1;
+
+// Maps the standard normals of a path to correlated log returns:
+//   x = drift + factor_t^T z_common + specific .* z_specific
+// with z_common the first factor_t.rows() normals and z_specific the rest (none
+// for a full Cholesky factor).
+struct PathFactors {
+    linalg::Matrix factor_t;
+    AlignedVector<double> specific;
+    MonteCarloModel model;
+
+    [[nodiscard]] std::size_t normals() const noexcept { return factor_t.rows() + specific.size(); }
+};
+
+// The PCA factor count is capped at the simulated dimension, where the model
+// becomes exact. The Cholesky factor is pivoted, so a rank-deficient covariance
+// draws only rank normals per path; a zero covariance keeps one unused normal.
+PathFactors compute_path_factors(const linalg::Matrix& cov, const MonteCarloOptions& sampling, std::size_t threads) {
+    const std::size_t dim = cov.rows();
+    PathFactors factors;
+    if (sampling.pca_factors == 0) {
+        const linalg::PivotedCholesky cholesky = linalg::pivoted_cholesky(cov, -1.0, threads);
+        factors.factor_t = cholesky.rank > 0 ? cholesky.factor.transposed() : linalg::Matrix(1, dim);
+        factors.model.rank = cholesky.rank;
+        factors.model.condition = cholesky.condition;
+    } else {
+        const std::size_t k = std::min(sampling.pca_factors, dim);
+        FactorModel pca = pca_factor_model(cov, k);
+        factors.factor_t = std::move(pca.loadings_t);
+        factors.specific = std::move(pca.specific);
+        factors.model.pca_factors = k;
+        factors.model.explained_variance = pca.explained_variance;
+    }
+    factors.model.factors = dim;
+    factors.model.normals = factors.normals();
+    return factors;
+}
+
+// Cache layout: factor_t, specific, then [rank, condition, explained variance,
+// pca factors]. The key covers the method and every covariance entry, so the
+// horizon scaling and the factor subset are part of it.
+std::optional<PathFactors> load_path_factors(const FactorCache& cache, const CacheKey& key, std::size_t dim) {
+    const std::optional<CacheEntry> entry = cache.load(key);
+    if (!entry || entry->size() != 3) {
+        return std::nullopt;
     }
-    const std::size_t expected = static_cast<std::size_t>(dim) * static_cast<std::size_t>(dim);
-    if (cov.size() != expected) {
-        throw std::invalid_argument("covariance matrix size mismatch");
+    const CacheArray& factor_t = entry->array(0);
+    const CacheArray& specific = entry->array(1);
+    const CacheArray& stats = entry->array(2);
+    if (factor_t.cols != dim || factor_t.rows == 0 || (specific.values.size() != 0 && specific.values.size() != dim) ||
+        stats.values.size() != 4) {
+        return std::nullopt;
     }
+    PathFactors factors;
+    factors.factor_t = linalg::Matrix(factor_t.rows, factor_t.cols);
+    std::copy(factor_t.values.begin(), factor_t.values.end(), factors.factor_t.values().begin());
+    factors.specific.assign(specific.values.begin(), specific.values.end());
+    factors.model.rank = static_cast<std::size_t>(stats.values[0]);
+    factors.model.condition = stats.values[1];
+    factors.model.explained_variance = stats.values[2];
+    factors.model.pca_factors = static_cast<std::size_t>(stats.values[3]);
+    factors.model.factors = dim;
+    factors.model.normals = factors.normals();
+    factors.model.cached = true;
+    return factors;
+}
 
-    std::vector<double> L(expected, 0.0);
-    constexpr double kEpsilon = 1e-12;
+PathFactors path_factors(const linalg::Matrix& cov, const MonteCarloOptions& sampling, std::size_t threads) {
+    if (sampling.factor_cache == nullptr) {
+        return compute_path_factors(cov, sampling, threads);
+    }
+    const CacheKey key = CacheKeyBuilder()
+                             .add("mc-path-factors")
+                             .add(kPathFactorsVersion)
+                             .add(static_cast<std::uint64_t>(std::min(sampling.pca_factors, cov.rows())))
+                             .add(static_cast<std::uint64_t>(cov.rows()))
+                             .add(cov.values())
+                             .key();
+    if (std::optional<PathFactors> cached = load_path_factors(*sampling.factor_cache, key, cov.rows())) {
+        return std::move(*cached);
+    }
+    PathFactors factors = compute_path_factors(cov, sampling, threads);
+    const std::vector<double> stats{static_cast<double>(factors.model.rank),
+                                    factors.model.condition,
+                                    factors.model.explained_variance,
+                                    static_cast<double>(factors.model.pca_factors)};
+    const CacheArray arrays[] = {
+        {factors.factor_t.rows(), factors.factor_t.cols(), factors.factor_t.values()},
+        {1, factors.specific.size(), factors.specific},
+        {1, stats.size(), stats},
+    };
+    sampling.factor_cache->store(key, arrays);
+    return factors;
+}
 
-    for (int i = 0; i < dim; ++i) {
-        for (int j = 0; j <= i; ++j) {
-            double sum = cov[static_cast<std::size_t>(i) * static_cast<std::size_t>(dim) + static_cast<std::size_t>(j)];
-            for (int k = 0; k < j; ++k) {
-                sum -= L[static_cast<std::size_t>(i) * static_cast<std::size_t>(dim) + static_cast<std::size_t>(k)] *
-                       L[static_cast<std::size_t>(j) * static_cast<std::size_t>(dim) + static_cast<std::size_t>(k)];
+// Standard normals of MC paths: the sampler's draws, mirrored in antithetic
+// pairs (path 2j + 1 is minus path 2j) and moved by the importance shift.
+class PathNormals {
+public:
+    PathNormals(std::size_t dim, std::uint64_t seed, const MonteCarloOptions& sampling, std::vector<double> shift)
+        : dim_(dim), seed_(seed), antithetic_(sampling.antithetic), shift_(std::move(shift)) {
+        if (sampling.sampler == MonteCarloSampler::Sobol) {
+            sobol_.emplace(dim, seed);
+        }
+        for (double v : shift_) {
+            half_shift_sq_ += 0.5 * v * v;
+        }
+    }
+
+    // Scratch values draw() needs for paths [begin, end).
+    [[nodiscard]] std::size_t scratch_size(std::size_t begin, std::size_t end) const {
+        return antithetic_ ? ((end + 1) / 2 - begin / 2) * dim_ : 0;
+    }
+
+    // Normals of paths [begin, end), row-major, into z.
+    void draw(std::size_t begin, std::size_t end, std::span<double> z, std::span<double> scratch) const {
+        draw_unshifted(begin, end, z, scratch);
+        if (shift_.empty()) {
+            return;
+        }
+        for (std::size_t r = 0; r < end - begin; ++r) {
+            for (std::size_t i = 0; i < dim_; ++i) {
+                z[r * dim_ + i] += shift_[i];
             }
-            if (i == j) {
-                if (sum < -kEpsilon) {
-                    throw std::invalid_argument("covariance matrix is not positive definite");
-                }
-                const double value = sum <= kEpsilon ? 0.0 : std::sqrt(sum);
-                L[static_cast<std::size_t>(i) * static_cast<std::size_t>(dim) + static_cast<std::size_t>(j)] = value;
-            } else {
-                const double diag = L[static_cast<std::size_t>(j) * static_cast<std::size_t>(dim) + static_cast<std::size_t>(j)];
-                if (std::abs(diag) <= kEpsilon) {
-                    L[static_cast<std::size_t>(i) * static_cast<std::size_t>(dim) + static_cast<std::size_t>(j)] = 0.0;
-                } else {
-                    L[static_cast<std::size_t>(i) * static_cast<std::size_t>(dim) + static_cast<std::size_t>(j)] = sum / diag;
-                }
+        }
+    }
+
+    // Likelihood ratio phi(z) / phi(z - shift) = exp(-shift . e - |shift|^2 / 2)
+    // of paths [begin, end), with e the unshifted normals.
+    void weights(std::size_t begin, std::size_t end, std::span<double> out) const {
+        const std::size_t rows = end - begin;
+        std::vector<double> e(rows * dim_);
+        std::vector<double> scratch(scratch_size(begin, end));
+        draw_unshifted(begin, end, e, scratch);
+        for (std::size_t r = 0; r < rows; ++r) {
+            const double projection = linalg::dot(std::span<const double>(e.data() + r * dim_, dim_), shift_);
+            out[r] = std::exp(-projection - half_shift_sq_);
+        }
+    }
+
+private:
+    void base(std::size_t begin, std::size_t end, std::span<double> out) const {
+        if (sobol_) {
+            sobol_->normals(begin, end, out);
+            return;
+        }
+        for (std::size_t p = begin; p < end; ++p) {
+            rng::path_normals(seed_, p, out.subspan((p - begin) * dim_, dim_));
+        }
+    }
+
+    void draw_unshifted(std::size_t begin, std::size_t end, std::span<double> z, std::span<double> scratch) const {
+        if (!antithetic_) {
+            base(begin, end, z);
+            return;
+        }
+        const std::size_t first = begin / 2;
+        base(first, (end + 1) / 2, scratch);
+        for (std::size_t p = begin; p < end; ++p) {
+            const double sign = p % 2 == 0 ? 1.0 : -1.0;
+            const double* from = scratch.data() + (p / 2 - first) * dim_;
+            double* to = z.data() + (p - begin) * dim_;
+            for (std::size_t i = 0; i < dim_; ++i) {
+                to[i] = sign * from[i];
             }
         }
     }
 
-    return L;
-}
+    std::size_t dim_;
+    std::uint64_t seed_;
+    bool antithetic_;
+    std::optional<rng::SobolSequence> sobol_;
+    std::vector<double> shift_;
+    double half_shift_sq_ = 0.0;
+};
 
-} // namespace
+// Importance-sampling mean shift in normal space: the direction in which the
+// portfolio's linear (delta) P&L falls fastest, at the length that centres the
+// proposal on the linear VaR point. Empty when the portfolio has no delta.
+std::vector<double> loss_shift(const InstrumentSoA& soa, const PathFactors& factors, double alpha) {
+    const std::size_t dim = factors.factor_t.cols();
+    const std::size_t common = factors.factor_t.rows();
+    const DeltaGammaModel model(soa, dim);
+    // d pnl / d z = (factor_t (dollar delta), specific .* dollar delta).
+    std::vector<double> gradient(factors.normals(), 0.0);
+    linalg::gemv(factors.factor_t.values(), common, dim, model.linear(), std::span<double>(gradient.data(), common));
+    for (std::size_t i = 0; i < factors.specific.size(); ++i) {
+        gradient[common + i] = factors.specific[i] * model.linear()[i];
+    }
+    const double norm = std::sqrt(linalg::dot(gradient, gradient));
+    if (norm == 0.0) {
+        return {};
+    }
+    const double length = rng::normal_quantile(alpha);
+    for (double& g : gradient) {
+        g *= -length / norm;
+    }
+    return gradient;
+}
 
-RiskMetrics compute_mcvar(const InstrumentSoA& soa,
-                          const Eigen::VectorXd& mu,
-                          const Eigen::MatrixXd& cov,
-                          double horizon_days,
-                          double alpha,
-                          int paths,
-                          std::uint64_t seed) {
+// Checks the inputs shared by compute_mcvar and compute_mcvar_adaptive and
+// returns the factor dimension.
+std::size_t checked_dimension(const Eigen::VectorXd& mu, const Eigen::MatrixXd& cov, double horizon_days, double alpha) {
     const std::size_t dim = static_cast<std::size_t>(mu.size());
     if (dim == 0) {
         throw std::invalid_argument("mu must have positive dimension");
@@ -78,70 +249,280 @@ RiskMetrics compute_mcvar(const InstrumentSoA& soa,
     if (!(alpha > 0.0 && alpha < 1.0)) {
         throw std::invalid_argument("alpha must be in (0,1)");
     }
-    if (paths <= 0) {
-        throw std::invalid_argument("paths must be positive");
-    }
     if (horizon_days <= 0.0) {
         throw std::invalid_argument("horizon_days must be positive");
     }
+    return dim;
+}
+
+// The universe factors a run simulates: those the portfolio references, with
+// the portfolio remapped onto them. A portfolio that references none still
+// gets one factor, so the scenario set is never empty.
+FactorSubset simulated_factors(const InstrumentSoA& soa, std::size_t universe, const MonteCarloOptions& sampling) {
+    if (sampling.pca_factors > universe) {
+        throw std::invalid_argument("pca_factors must not exceed the universe size");
+    }
+    FactorSubset subset = referenced_factors(soa, universe);
+    if (subset.factors.empty()) {
+        subset.factors.push_back(0);
+    }
+    return subset;
+}
 
-    std::vector<double> drift(dim, 0.0);
-    for (std::size_t i = 0; i < dim; ++i) {
-        drift[i] = mu(static_cast<Eigen::Index>(i)) * horizon_days;
+std::vector<double> scaled_drift(const Eigen::VectorXd& mu, std::span<const std::uint32_t> factors, double horizon_days) {
+    const std::span<const double> mean = mu.values();
+    std::vector<double> drift(factors.size(), 0.0);
+    for (std::size_t i = 0; i < drift.size(); ++i) {
+        drift[i] = mean[factors[i]] * horizon_days;
     }
+    return drift;
+}
 
-    std::vector<double> cov_scaled(dim * dim, 0.0);
+linalg::Matrix scaled_covariance(const Eigen::MatrixXd& cov, std::span<const std::uint32_t> factors, double horizon_days) {
+    const std::size_t dim = factors.size();
+    linalg::Matrix cov_scaled(dim, dim);
     for (std::size_t r = 0; r < dim; ++r) {
+        const std::span<const double> source = cov.row(static_cast<Eigen::Index>(factors[r]));
+        double* target = cov_scaled.row(r).data();
         for (std::size_t c = 0; c < dim; ++c) {
-            cov_scaled[r * dim + c] = cov(static_cast<Eigen::Index>(r), static_cast<Eigen::Index>(c)) * horizon_days;
+            target[c] = source[factors[c]] * horizon_days;
         }
     }
+    return cov_scaled;
+}
+
+// The first `paths` Monte Carlo paths as a scenario set over the factors the
+// portfolio references; soa() is the portfolio remapped onto them. Shocks of a
+// block of paths are expm1(drift + Z L^T) with row p of Z holding the normals
+// of path p, L the Cholesky factor or the PCA loadings (plus the idiosyncratic
+// terms, which are applied element-wise). Each row is a pure function of its
+// path index (gemm does not mix rows), so paths can be generated in any
+// grouping.
+class PathScenarios {
+public:
+    PathScenarios(const InstrumentSoA& soa,
+                  const Eigen::VectorXd& mu,
+                  const Eigen::MatrixXd& cov,
+                  double horizon_days,
+                  double alpha,
+                  std::size_t paths,
+                  std::uint64_t seed,
+                  const MonteCarloOptions& sampling,
+                  std::size_t threads)
+        : subset_(simulated_factors(soa, checked_dimension(mu, cov, horizon_days, alpha), sampling)),
+          dim_(subset_.factors.size()),
+          drift_(scaled_drift(mu, subset_.factors, horizon_days)),
+          cov_scaled_(scaled_covariance(cov, subset_.factors, horizon_days)),
+          factors_(path_factors(cov_scaled_, sampling, threads)),
+          shift_(sampling.importance_sampling ? loss_shift(subset_.soa, factors_, alpha) : std::vector<double>{}),
+          normals_(factors_.normals(), seed, sampling, shift_) {
+        set_.rows = paths;
+        set_.factors = dim_;
+        set_.error_batches = kErrorBatches;
+        set_.block = [this](std::size_t begin, std::size_t end, std::vector<double>& scratch) {
+            return block(begin, end, scratch);
+        };
+        if (!shift_.empty()) {
+            set_.weights = [this](std::size_t begin, std::size_t end, std::span<double> out) {
+                normals_.weights(begin, end, out);
+            };
+        }
 
-    const std::vector<double> sqrt_cov = compute_cholesky(std::span<const double>(cov_scaled.data(), cov_scaled.size()), static_cast<int>(dim));
+        // Grid ladders and P&L bounds span drift +/- k sigma of each log return.
+        // The largest of paths * normals standard normals stays below
+        // sqrt(2 ln(paths * normals)) with high probability; one extra sigma keeps the
+        // paths outside (grid fallbacks, unbounded scenarios) rare.
+        // The importance shift moves a log return by at most |shift| sigma.
+        const double draws = static_cast<double>(paths) * static_cast<double>(factors_.normals());
+        const double k = std::sqrt(2.0 * std::log(draws)) + 1.0 + std::sqrt(linalg::dot(shift_, shift_));
+        set_.ranges.resize(dim_);
+        for (std::size_t i = 0; i < dim_; ++i) {
+            const double sigma = std::sqrt(std::max(cov_scaled_(i, i), 0.0));
+            set_.ranges[i] = ShockRange{std::expm1(drift_[i] - k * sigma), std::expm1(drift_[i] + k * sigma)};
+        }
+    }
 
-    std::mt19937_64 rng(seed);
-    std::normal_distribution<double> norm01(0.0, 1.0);
+    PathScenarios(const PathScenarios&) = delete;
+    PathScenarios& operator=(const PathScenarios&) = delete;
 
-    std::vector<double> pnls(static_cast<std::size_t>(paths), 0.0);
-    std::vector<double> z(dim, 0.0);
-    std::vector<double> shocks(dim, 0.0);
+    [[nodiscard]] const InstrumentSoA& soa() const noexcept { return subset_.soa; }
+    [[nodiscard]] const ScenarioSet& set() const noexcept { return set_; }
+    [[nodiscard]] const MonteCarloModel& model() const noexcept { return factors_.model; }
 
-    for (int path = 0; path < paths; ++path) {
-        for (std::size_t i = 0; i < dim; ++i) {
-            z[i] = norm01(rng);
+private:
+    std::span<const double> block(std::size_t begin, std::size_t end, std::vector<double>& scratch) const {
+        const std::size_t rows = end - begin;
+        const std::size_t normals = factors_.normals();
+        const std::size_t common = factors_.factor_t.rows();
+        const bool split = !factors_.specific.empty();
+        const std::size_t extra = normals_.scratch_size(begin, end);
+        scratch.resize(rows * (dim_ + normals + (split ? common : 0)) + extra);
+        double* next = scratch.data();
+        const std::span<double> shocks(next, rows * dim_);
+        next += shocks.size();
+        const std::span<double> z(next, rows * normals);
+        next += z.size();
+        std::span<double> z_common = z;
+        if (split) {
+            z_common = std::span<double>(next, rows * common);
+            next += z_common.size();
+        }
+        normals_.draw(begin, end, z, std::span<double>(next, extra));
+        for (std::size_t r = 0; r < rows; ++r) {
+            std::copy(drift_.begin(), drift_.end(), shocks.begin() + static_cast<std::ptrdiff_t>(r * dim_));
         }
-        for (std::size_t i = 0; i < dim; ++i) {
-            double sum = 0.0;
-            for (std::size_t k = 0; k < dim; ++k) {
-                sum += sqrt_cov[i * dim + k] * z[k];
+        if (split) {
+            for (std::size_t r = 0; r < rows; ++r) {
+                std::copy_n(z.data() + r * normals, common, z_common.data() + r * common);
             }
-            const double log_return = drift[i] + sum;
-            shocks[i] = std::expm1(log_return);
         }
-        pnls[static_cast<std::size_t>(path)] = hvarday(soa, shocks.data());
+        linalg::gemm(z_common, rows, common, factors_.factor_t.values(), dim_, shocks);
+        if (split) {
+            for (std::size_t r = 0; r < rows; ++r) {
+                const double* z_specific = z.data() + r * normals + common;
+                double* row = shocks.data() + r * dim_;
+                for (std::size_t i = 0; i < dim_; ++i) {
+                    row[i] += factors_.specific[i] * z_specific[i];
+                }
+            }
+        }
+        vmath::expm1(shocks, shocks);
+        return shocks;
     }
 
-    std::vector<double> pnls_copy = pnls;
-    const double q = std::clamp(1.0 - alpha, 0.0, 1.0);
-    const double var_quantile = quantile_inplace(pnls_copy, q);
+    FactorSubset subset_;
+    std::size_t dim_;
+    std::vector<double> drift_;
+    linalg::Matrix cov_scaled_;
+    PathFactors factors_;
+    std::vector<double> shift_;
+    PathNormals normals_;
+    ScenarioSet set_;
+};
 
-    double tail_sum = 0.0;
-    std::size_t tail_count = 0;
-    for (double pnl : pnls) {
-        if (pnl <= var_quantile) {
-            tail_sum += pnl;
-            ++tail_count;
-        }
+// Two-sided Student-t critical value at the given confidence, from the normal
+// quantile by the Cornish-Fisher expansion (error below 1e-3 for dof >= 10).
+double t_critical(double confidence, double dof) {
+    const double z = rng::normal_quantile(0.5 + 0.5 * confidence);
+    const double z3 = z * z * z;
+    const double z5 = z3 * z * z;
+    return z + (z3 + z) / (4.0 * dof) + (5.0 * z5 + 16.0 * z3 + 3.0 * z) / (96.0 * dof * dof);
+}
+
+// Half-width over its target, tolerance * |estimate|. A zero-width interval
+// (e.g. a book with no P&L) has met any target; a non-zero one around a zero
+// estimate never does.
+double width_ratio(double half_width, double estimate, double tolerance) {
+    if (half_width == 0.0) {
+        return 0.0;
+    }
+    const double target = tolerance * std::abs(estimate);
+    return target > 0.0 ? half_width / target : std::numeric_limits<double>::infinity();
+}
+
+} // namespace
+
+RiskMetrics compute_mcvar(const InstrumentSoA& soa,
+                          const Eigen::VectorXd& mu,
+                          const Eigen::MatrixXd& cov,
+                          double horizon_days,
+                          double alpha,
+                          int paths,
+                          std::uint64_t seed,
+                          const RevaluationOptions& revaluation,
+                          RevaluationStats* stats,
+                          const MonteCarloOptions& sampling,
+                          MonteCarloModel* model) {
+    if (paths <= 0) {
+        throw std::invalid_argument("paths must be positive");
     }
-    if (tail_count == 0) {
-        tail_sum += var_quantile;
-        tail_count = 1;
+    const PathScenarios scenarios(
+        soa, mu, cov, horizon_days, alpha, static_cast<std::size_t>(paths), seed, sampling, revaluation.threads);
+    if (model != nullptr) {
+        *model = scenarios.model();
     }
+    return scenario_risk(scenarios.soa(), scenarios.set(), alpha, revaluation, stats);
+}
 
-    RiskMetrics metrics;
-    metrics.var = -var_quantile;
-    metrics.cvar = -(tail_sum / static_cast<double>(tail_count));
-    return metrics;
+AdaptiveMonteCarloResult compute_mcvar_adaptive(const InstrumentSoA& soa,
+                                                const Eigen::VectorXd& mu,
+                                                const Eigen::MatrixXd& cov,
+                                                double horizon_days,
+                                                double alpha,
+                                                std::uint64_t seed,
+                                                const AdaptiveMonteCarloOptions& adaptive,
+                                                const RevaluationOptions& revaluation,
+                                                RevaluationStats* stats,
+                                                const MonteCarloOptions& sampling) {
+    using Clock = std::chrono::steady_clock;
+    const Clock::time_point start = Clock::now();
+    auto elapsed = [&start] { return std::chrono::duration<double>(Clock::now() - start).count(); };
+
+    if (!(adaptive.tolerance > 0.0)) {
+        throw std::invalid_argument("adaptive tolerance must be positive");
+    }
+    if (!(adaptive.confidence > 0.0 && adaptive.confidence < 1.0)) {
+        throw std::invalid_argument("adaptive confidence must be in (0,1)");
+    }
+    if (adaptive.initial_paths <= 0 || adaptive.max_paths < adaptive.initial_paths) {
+        throw std::invalid_argument("adaptive path counts must satisfy 0 < initial_paths <= max_paths");
+    }
+    // Fewer paths give no batch-means standard errors, hence no interval to test.
+    if (static_cast<std::size_t>(adaptive.initial_paths) < 2 * kErrorBatches) {
+        throw std::invalid_argument("adaptive Monte Carlo needs at least " + std::to_string(2 * kErrorBatches) +
+                                    " initial paths");
+    }
+    if (revaluation.prune_tail) {
+        throw std::invalid_argument("adaptive Monte Carlo needs standard errors, which tail pruning does not provide");
+    }
+
+    const auto max_paths = static_cast<std::size_t>(adaptive.max_paths);
+    const PathScenarios scenarios(soa, mu, cov, horizon_days, alpha, max_paths, seed, sampling, revaluation.threads);
+    ScenarioRisk risk(scenarios.soa(), scenarios.set(), alpha, revaluation);
+    const double critical = t_critical(adaptive.confidence, static_cast<double>(kErrorBatches - 1));
+
+    AdaptiveMonteCarloResult result;
+    result.model = scenarios.model();
+    std::size_t paths = static_cast<std::size_t>(adaptive.initial_paths);
+    for (;;) {
+        const double round_start = elapsed();
+        const std::size_t priced = risk.rows();
+        risk.extend(paths);
+        result.metrics = risk.metrics(stats);
+        result.paths = paths;
+        result.var_half_width = critical * result.metrics.var_stderr;
+        result.cvar_half_width = critical * result.metrics.cvar_stderr;
+        result.elapsed_seconds = elapsed();
+
+        // Half-widths shrink like 1 / sqrt(paths): the worse of the two ratios
+        // to target predicts the paths still needed.
+        const double var_ratio = width_ratio(result.var_half_width, result.metrics.var, adaptive.tolerance);
+        const double cvar_ratio = width_ratio(result.cvar_half_width, result.metrics.cvar, adaptive.tolerance);
+        const double ratio = std::max(var_ratio, cvar_ratio);
+        result.converged = ratio <= 1.0;
+        if (result.converged || paths >= max_paths) {
+            break;
+        }
+
+        // Grow by 1.25x to 4x, and never past what the time budget can pay for
+        // at the rate of the last round.
+        const double growth = std::isfinite(ratio) ? std::min(ratio * ratio * 1.1, 4.0) : 4.0;
+        const double wanted = std::ceil(static_cast<double>(paths) * growth);
+        std::size_t next = std::max(static_cast<std::size_t>(std::min(wanted, static_cast<double>(max_paths))),
+                                    paths + paths / 4);
+        next = std::min(next, max_paths);
+        if (adaptive.time_budget_seconds > 0.0) {
+            const double remaining = adaptive.time_budget_seconds - result.elapsed_seconds;
+            const double per_path = (result.elapsed_seconds - round_start) / static_cast<double>(paths - priced);
+            const double affordable = per_path > 0.0 ? remaining / per_path : static_cast<double>(max_paths);
+            if (affordable < static_cast<double>(paths / 4)) {
+                break;
+            }
+            next = std::min(next, paths + static_cast<std::size_t>(affordable));
+        }
+        paths = next;
+    }
+    return result;
 }
 
 } // namespace risk
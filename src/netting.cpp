@@ -0,0 +1,92 @@
+#include <risk/netting.hpp>
+
+#include <bit>
+#include <cstdint>
+#include <unordered_map>
+
+#include <risk/instrument.hpp>
+
+namespace risk {
+
+namespace {
+
+// Field-wise bit patterns, so contracts net only when bit-for-bit identical.
+struct ContractKey {
+    std::uint8_t type = 0;
+    std::uint8_t is_call = 0;
+    std::uint32_t index = 0;
+    std::uint64_t terms[5] = {};
+
+    bool operator==(const ContractKey&) const = default;
+};
+
+struct ContractKeyHash {
+    std::size_t operator()(const ContractKey& key) const noexcept {
+        std::uint64_t h = 1469598103934665603ULL;
+        auto mix = [&h](std::uint64_t value) {
+            h ^= value;
+            h *= 1099511628211ULL;
+        };
+        mix((static_cast<std::uint64_t>(key.type) << 40) | (static_cast<std::uint64_t>(key.is_call) << 32) | key.index);
+        for (std::uint64_t term : key.terms) {
+            mix(term);
+        }
+        return static_cast<std::size_t>(h);
+    }
+};
+
+std::uint64_t bits_of(double value) {
+    // + 0.0 folds -0.0 into +0.0.
+    return std::bit_cast<std::uint64_t>(value + 0.0);
+}
+
+double resolved_underlying(const InstrumentSoA& soa, std::size_t i) {
+    return soa.underlying_price[i] > 0.0 ? soa.underlying_price[i] : soa.current_price[i];
+}
+
+ContractKey make_key(const InstrumentSoA& soa, std::size_t i) {
+    ContractKey key;
+    key.type = soa.type[i];
+    if (soa.type[i] != static_cast<std::uint8_t>(InstrumentType::Option)) {
+        key.index = soa.id[i];
+        key.terms[0] = bits_of(soa.current_price[i]);
+        return key;
+    }
+    key.is_call = soa.is_call[i] != 0 ? 1 : 0;
+    key.index = soa.underlying_index[i];
+    key.terms[0] = bits_of(resolved_underlying(soa, i));
+    key.terms[1] = bits_of(soa.strike[i]);
+    key.terms[2] = bits_of(soa.time_to_maturity[i]);
+    key.terms[3] = bits_of(soa.implied_vol[i]);
+    key.terms[4] = bits_of(soa.rate[i]);
+    return key;
+}
+
+} // namespace
+
+NettedContracts net_contracts(const InstrumentSoA& soa) {
+    NettedContracts netted;
+    const std::size_t n = soa.size();
+    netted.line_to_contract.reserve(n);
+
+    std::unordered_map<ContractKey, std::size_t, ContractKeyHash> index;
+    index.reserve(n);
+
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto [it, inserted] = index.try_emplace(make_key(soa, i), netted.contracts.size());
+        const std::size_t contract = it->second;
+        if (inserted) {
+            append_instrument(netted.contracts, soa, i);
+            netted.contracts.underlying_price.back() = resolved_underlying(soa, i);
+            netted.contracts.qty.back() = 0.0;
+            netted.value_today.push_back(0.0);
+        }
+        netted.contracts.qty[contract] += soa.qty[i];
+        netted.value_today[contract] += soa.qty[i] * soa.current_price[i];
+        netted.line_to_contract.push_back(contract);
+    }
+
+    return netted;
+}
+
+} // namespace risk
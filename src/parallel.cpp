@@ -0,0 +1,73 @@
+#include <risk/parallel.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace risk {
+
+std::size_t resolve_thread_count(std::size_t threads) {
+    if (threads > 0) {
+        return threads;
+    }
+    return std::max<std::size_t>(1, std::thread::hardware_concurrency());
+}
+
+void parallel_for(std::size_t n,
+                  std::size_t block_size,
+                  std::size_t threads,
+                  const std::function<void(std::size_t block, std::size_t begin, std::size_t end)>& body) {
+    if (block_size == 0) {
+        throw std::invalid_argument("parallel_for requires a positive block size");
+    }
+    const std::size_t blocks = (n + block_size - 1) / block_size;
+    const std::size_t workers = std::min(resolve_thread_count(threads), blocks);
+    if (workers <= 1) {
+        for (std::size_t b = 0; b < blocks; ++b) {
+            body(b, b * block_size, std::min(n, (b + 1) * block_size));
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next{0};
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::mutex error_mutex;
+
+    auto work = [&]() {
+        for (;;) {
+            const std::size_t b = next.fetch_add(1, std::memory_order_relaxed);
+            if (b >= blocks || failed.load(std::memory_order_relaxed)) {
+                return;
+            }
+            try {
+                body(b, b * block_size, std::min(n, (b + 1) * block_size));
+            } catch (...) {
+                const std::lock_guard<std::mutex> lock(error_mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                failed.store(true, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(workers - 1);
+    for (std::size_t w = 1; w < workers; ++w) {
+        pool.emplace_back(work);
+    }
+    work();
+    for (std::thread& thread : pool) {
+        thread.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace risk
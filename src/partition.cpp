@@ -0,0 +1,25 @@
+#include <risk/partition.hpp>
+
+#include <risk/instrument.hpp>
+
+namespace risk {
+
+PartitionedSoA partition_by_kind(const InstrumentSoA& soa) {
+    PartitionedSoA parts;
+    const std::size_t n = soa.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        if (soa.type[i] != static_cast<std::uint8_t>(InstrumentType::Option)) {
+            append_instrument(parts.equities, soa, i);
+            parts.equity_index.push_back(i);
+        } else if (soa.is_call[i] != 0) {
+            append_instrument(parts.calls, soa, i);
+            parts.call_index.push_back(i);
+        } else {
+            append_instrument(parts.puts, soa, i);
+            parts.put_index.push_back(i);
+        }
+    }
+    return parts;
+}
+
+} // namespace risk
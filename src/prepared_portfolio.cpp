@@ -0,0 +1,183 @@
+#include <risk/prepared_portfolio.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+
+#include <risk/bs.hpp>
+#include <risk/linalg.hpp>
+#include <risk/netting.hpp>
+#include <risk/partition.hpp>
+#include <risk/vmath.hpp>
+
+namespace risk {
+
+namespace {
+
+// Same floors as bs::price, applied once instead of per scenario.
+constexpr double kMinTime = 1e-8;
+constexpr double kMinVol = 1e-8;
+
+// Options per pass of the option kernels; keeps the stage temporaries in L1.
+constexpr std::size_t kBlock = 256;
+
+AlignedVector<double> prepare_equity_exposure(const InstrumentSoA& equities, std::size_t factor_count) {
+    AlignedVector<double> exposure(factor_count, 0.0);
+    const std::size_t n = equities.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        if (equities.id[i] >= factor_count) {
+            throw std::out_of_range("equity id exceeds shock dimension");
+        }
+        exposure[equities.id[i]] += equities.current_price[i] * equities.qty[i];
+    }
+    return exposure;
+}
+
+PreparedOptions prepare_options(const InstrumentSoA& lines, std::size_t factor_count) {
+    // Identical contracts across lines/accounts are priced once with their net qty.
+    const NettedContracts netted = net_contracts(lines);
+    const InstrumentSoA& options = netted.contracts;
+
+    PreparedOptions prepared;
+    const std::size_t n = options.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        if (options.underlying_index[i] >= factor_count) {
+            throw std::out_of_range("underlying index exceeds shock dimension");
+        }
+        // net_contracts has already resolved the underlying_price fallback.
+        const double underlying_today = options.underlying_price[i];
+        const double strike = options.strike[i];
+        const double rate = options.rate[i];
+        const double tau = std::max(options.time_to_maturity[i], kMinTime);
+        const double vol = std::max(options.implied_vol[i], kMinVol);
+
+        // A non-positive strike prices at zero in bs::price; a zero spot reproduces that.
+        const bool priceable = strike > 0.0;
+        prepared.factor.push_back(options.underlying_index[i]);
+        prepared.spot.push_back(priceable ? underlying_today : 0.0);
+        prepared.inv_strike.push_back(priceable ? 1.0 / strike : 0.0);
+        prepared.drift.push_back((rate + 0.5 * vol * vol) * tau);
+        prepared.vol_sqrt_tau.push_back(vol * std::sqrt(tau));
+        prepared.disc_strike.push_back(strike * std::exp(-rate * tau));
+        prepared.qty.push_back(options.qty[i]);
+        prepared.value_today += netted.value_today[i];
+    }
+    return prepared;
+}
+
+// Shocked value of one partition. Specialized per kind so the payoff is fixed
+// at compile time and the loops carry no type or call/put selects.
+template <class Kind>
+double revalue(const PreparedOptions& options, const double* shocks_row);
+
+template <class Kind>
+double revalue(const AlignedVector<double>& exposure, const double* shocks_row);
+
+template <>
+double revalue<kind::Equity>(const AlignedVector<double>& exposure, const double* shocks_row) {
+    return linalg::dot(exposure, std::span<const double>(shocks_row, exposure.size()));
+}
+
+template <class Kind>
+double revalue(const PreparedOptions& options, const double* shocks_row) {
+    static_assert(std::is_same_v<Kind, kind::Call> || std::is_same_v<Kind, kind::Put>);
+    // Puts evaluate N(-d1), N(-d2) and flip the sign of the call expression:
+    // put = -(S N(-d1) - K D N(-d2)).
+    constexpr double sign = std::is_same_v<Kind, kind::Call> ? 1.0 : -1.0;
+
+    alignas(64) double spot[kBlock];
+    alignas(64) double moneyness[kBlock];
+    alignas(64) double nd1[kBlock];
+    alignas(64) double nd2[kBlock];
+
+    double value = 0.0;
+    const std::size_t n = options.size();
+    for (std::size_t base = 0; base < n; base += kBlock) {
+        const std::size_t m = std::min(kBlock, n - base);
+        const std::span<double> moneyness_span(moneyness, m);
+        const std::span<double> nd1_span(nd1, m);
+        const std::span<double> nd2_span(nd2, m);
+
+        for (std::size_t i = 0; i < m; ++i) {
+            const std::size_t j = base + i;
+            const double s = options.spot[j] * (1.0 + shocks_row[options.factor[j]]);
+            spot[i] = s;
+            moneyness[i] = s > 0.0 ? s * options.inv_strike[j] : 1.0;
+        }
+
+        vmath::log(moneyness_span, moneyness_span);
+
+        for (std::size_t i = 0; i < m; ++i) {
+            const std::size_t j = base + i;
+            const double d1 = (moneyness[i] + options.drift[j]) / options.vol_sqrt_tau[j];
+            const double d2 = d1 - options.vol_sqrt_tau[j];
+            nd1[i] = sign * d1;
+            nd2[i] = sign * d2;
+        }
+
+        vmath::normal_cdf(nd1_span, nd1_span);
+        vmath::normal_cdf(nd2_span, nd2_span);
+
+        for (std::size_t i = 0; i < m; ++i) {
+            const std::size_t j = base + i;
+            const double price = sign * (spot[i] * nd1[i] - options.disc_strike[j] * nd2[i]);
+            value += options.qty[j] * (spot[i] > 0.0 ? price : 0.0);
+        }
+    }
+    return value;
+}
+
+} // namespace
+
+ContractValue contract_value(const PreparedOptions& options, std::size_t j, double spot, bool is_call) {
+    ContractValue value;
+    if (options.spot[j] <= 0.0 || spot <= 0.0) {
+        return value;
+    }
+    const double d1 = (std::log(spot * options.inv_strike[j]) + options.drift[j]) / options.vol_sqrt_tau[j];
+    const double d2 = d1 - options.vol_sqrt_tau[j];
+    if (is_call) {
+        value.price = spot * bs::normal_cdf(d1) - options.disc_strike[j] * bs::normal_cdf(d2);
+        value.delta = bs::normal_cdf(d1);
+    } else {
+        value.price = options.disc_strike[j] * bs::normal_cdf(-d2) - spot * bs::normal_cdf(-d1);
+        value.delta = -bs::normal_cdf(-d1);
+    }
+    return value;
+}
+
+PreparedPortfolio::PreparedPortfolio(const InstrumentSoA& soa, std::size_t factor_count)
+    : factor_count_(factor_count) {
+    const PartitionedSoA parts = partition_by_kind(soa);
+    equity_count_ = parts.equities.size();
+    option_count_ = parts.calls.size() + parts.puts.size();
+    equity_exposure_ = prepare_equity_exposure(parts.equities, factor_count);
+    calls_ = prepare_options(parts.calls, factor_count);
+    puts_ = prepare_options(parts.puts, factor_count);
+}
+
+double PreparedPortfolio::revalue(const double* shocks_row) const {
+    if (shocks_row == nullptr) {
+        throw std::invalid_argument("shocks_row must not be null");
+    }
+    return risk::revalue<kind::Equity>(equity_exposure_, shocks_row) + option_pnl(shocks_row);
+}
+
+void PreparedPortfolio::equity_pnl(std::span<const double> shocks_flat,
+                                   std::size_t rows,
+                                   std::span<double> out) const {
+    linalg::gemv(shocks_flat, rows, factor_count_, equity_exposure_, out);
+}
+
+double PreparedPortfolio::option_pnl(const double* shocks_row) const {
+    if (shocks_row == nullptr) {
+        throw std::invalid_argument("shocks_row must not be null");
+    }
+    const double call_value = risk::revalue<kind::Call>(calls_, shocks_row);
+    const double put_value = risk::revalue<kind::Put>(puts_, shocks_row);
+    return (call_value - calls_.value_today) + (put_value - puts_.value_today);
+}
+
+} // namespace risk
@@ -0,0 +1,184 @@
+#include <risk/pricing_grid.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace risk {
+
+namespace {
+
+// Ladders narrower than this are widened so the node spacing stays positive.
+constexpr double kMinWidth = 1e-6;
+
+// Adds qty * price and qty * d price / d shock of each contract, at every node
+// of its underlying's ladder, into the per-factor curves.
+void tabulate(const PreparedOptions& options,
+              bool is_call,
+              const std::vector<std::size_t>& slot,
+              const std::vector<double>& lo,
+              const std::vector<double>& step,
+              std::size_t nodes,
+              AlignedVector<double>& value,
+              AlignedVector<double>& slope) {
+    for (std::size_t j = 0; j < options.size(); ++j) {
+        const double spot_today = options.spot[j];
+        if (spot_today <= 0.0) {
+            continue;
+        }
+        const std::size_t f = slot[options.factor[j]];
+        for (std::size_t k = 0; k < nodes; ++k) {
+            const double spot = spot_today * (1.0 + lo[f] + step[f] * static_cast<double>(k));
+            if (spot <= 0.0) {
+                continue;
+            }
+            const ContractValue v = contract_value(options, j, spot, is_call);
+            value[f * nodes + k] += options.qty[j] * v.price;
+            slope[f * nodes + k] += options.qty[j] * v.delta * spot_today * step[f];
+        }
+    }
+}
+
+} // namespace
+
+std::vector<ShockRange> shock_ranges(std::span<const double> shocks_flat, std::size_t rows, std::size_t cols) {
+    if (shocks_flat.size() != rows * cols) {
+        throw std::invalid_argument("shock matrix size mismatch in shock_ranges");
+    }
+    std::vector<ShockRange> ranges(cols, ShockRange{std::numeric_limits<double>::infinity(),
+                                                    -std::numeric_limits<double>::infinity()});
+    for (std::size_t t = 0; t < rows; ++t) {
+        const double* row = shocks_flat.data() + t * cols;
+        for (std::size_t i = 0; i < cols; ++i) {
+            ranges[i].lo = std::min(ranges[i].lo, row[i]);
+            ranges[i].hi = std::max(ranges[i].hi, row[i]);
+        }
+    }
+    return ranges;
+}
+
+PricingGrid::PricingGrid(const PreparedPortfolio& prepared, std::span<const ShockRange> ranges, std::size_t nodes)
+    : nodes_(nodes) {
+    if (nodes < 2) {
+        throw std::invalid_argument("pricing grid needs at least two nodes");
+    }
+    if (ranges.size() != prepared.factor_count()) {
+        throw std::invalid_argument("shock ranges must cover every factor");
+    }
+
+    const PreparedOptions& calls = prepared.calls();
+    const PreparedOptions& puts = prepared.puts();
+    value_today_ = calls.value_today + puts.value_today;
+
+    constexpr std::size_t kUnused = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> slot(prepared.factor_count(), kUnused);
+    for (const PreparedOptions* options : {&calls, &puts}) {
+        for (std::uint32_t factor : options->factor) {
+            if (slot[factor] != kUnused) {
+                continue;
+            }
+            slot[factor] = factors_.size();
+            factors_.push_back(factor);
+
+            double lo = ranges[factor].lo;
+            double hi = ranges[factor].hi;
+            if (!(std::isfinite(lo) && std::isfinite(hi) && lo <= hi)) {
+                throw std::invalid_argument("shock range must be finite with lo <= hi");
+            }
+            if (hi - lo < kMinWidth) {
+                const double mid = 0.5 * (lo + hi);
+                lo = mid - 0.5 * kMinWidth;
+                hi = mid + 0.5 * kMinWidth;
+            }
+            lo_.push_back(lo);
+            hi_.push_back(hi);
+            step_.push_back((hi - lo) / static_cast<double>(nodes - 1));
+        }
+    }
+
+    value_.assign(factors_.size() * nodes, 0.0);
+    slope_.assign(factors_.size() * nodes, 0.0);
+    tabulate(calls, true, slot, lo_, step_, nodes, value_, slope_);
+    tabulate(puts, false, slot, lo_, step_, nodes, value_, slope_);
+}
+
+bool PricingGrid::covers(const double* shocks_row) const {
+    if (shocks_row == nullptr) {
+        throw std::invalid_argument("shocks_row must not be null");
+    }
+    bool inside = true;
+    for (std::size_t f = 0; f < factors_.size(); ++f) {
+        const double x = shocks_row[factors_[f]];
+        // Written so that NaN shocks count as uncovered.
+        inside = inside && (x >= lo_[f] && x <= hi_[f]);
+    }
+    return inside;
+}
+
+double PricingGrid::option_pnl(const double* shocks_row) const {
+    if (shocks_row == nullptr) {
+        throw std::invalid_argument("shocks_row must not be null");
+    }
+    const double last = static_cast<double>(nodes_ - 2);
+    double value = 0.0;
+    for (std::size_t f = 0; f < factors_.size(); ++f) {
+        const double u = (shocks_row[factors_[f]] - lo_[f]) / step_[f];
+        const double cell = std::clamp(std::floor(u), 0.0, last);
+        const double t = u - cell;
+        const std::size_t k = f * nodes_ + static_cast<std::size_t>(cell);
+
+        // Cubic Hermite basis on [0, 1].
+        const double t2 = t * t;
+        const double t3 = t2 * t;
+        const double h00 = 2.0 * t3 - 3.0 * t2 + 1.0;
+        const double h10 = t3 - 2.0 * t2 + t;
+        const double h01 = 3.0 * t2 - 2.0 * t3;
+        const double h11 = t3 - t2;
+        value += h00 * value_[k] + h10 * slope_[k] + h01 * value_[k + 1] + h11 * slope_[k + 1];
+    }
+    return value - value_today_;
+}
+
+GridRevaluer::GridRevaluer(const PreparedPortfolio& prepared,
+                           const PricingGrid& grid,
+                           std::size_t rows,
+                           std::size_t check_rows)
+    : prepared_(prepared), grid_(grid) {
+    stats_.grid_nodes = grid.node_count();
+    if (check_rows > 0) {
+        check_stride_ = std::max<std::size_t>(1, rows / check_rows);
+    }
+}
+
+double GridRevaluer::option_pnl(std::size_t row_index, const double* shocks_row) {
+    if (!grid_.covers(shocks_row)) {
+        ++stats_.fallback_rows;
+        return prepared_.option_pnl(shocks_row);
+    }
+    const double value = grid_.option_pnl(shocks_row);
+    if (check_stride_ > 0 && row_index % check_stride_ == 0) {
+        const double error = std::abs(value - prepared_.option_pnl(shocks_row));
+        ++stats_.checked_rows;
+        stats_.max_abs_error = std::max(stats_.max_abs_error, error);
+        sum_sq_error_ += error * error;
+    }
+    return value;
+}
+
+void GridRevaluer::merge(const GridRevaluer& other) {
+    stats_.fallback_rows += other.stats_.fallback_rows;
+    stats_.checked_rows += other.stats_.checked_rows;
+    stats_.max_abs_error = std::max(stats_.max_abs_error, other.stats_.max_abs_error);
+    sum_sq_error_ += other.sum_sq_error_;
+}
+
+RevaluationStats GridRevaluer::stats() const {
+    RevaluationStats stats = stats_;
+    if (stats.checked_rows > 0) {
+        stats.rms_error = std::sqrt(sum_sq_error_ / static_cast<double>(stats.checked_rows));
+    }
+    return stats;
+}
+
+} // namespace risk
@@ -0,0 +1,384 @@
+#include <risk/revaluation.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <optional>
+#include <span>
+#include <stdexcept>
+
+#include <risk/delta_gamma.hpp>
+#include <risk/parallel.hpp>
+#include <risk/prepared_portfolio.hpp>
+#include <risk/pricing_grid.hpp>
+#include <risk/tail_bounds.hpp>
+
+namespace risk {
+
+namespace {
+
+// VaR and ES from scenario P&L. quantile_index is floor(q * (n - 1)) over the
+// full scenario set; pnls may omit scenarios known to lie above the quantile,
+// which changes neither the order statistic nor the tail sum.
+RiskMetrics tail_metrics(std::span<const double> pnls, std::size_t quantile_index) {
+    std::vector<double> pnls_copy(pnls.begin(), pnls.end());
+    auto nth = pnls_copy.begin() + static_cast<std::ptrdiff_t>(quantile_index);
+    std::nth_element(pnls_copy.begin(), nth, pnls_copy.end());
+    const double var_quantile = *nth;
+
+    double tail_sum = 0.0;
+    std::size_t tail_count = 0;
+    for (double pnl : pnls) {
+        if (pnl <= var_quantile) {
+            tail_sum += pnl;
+            ++tail_count;
+        }
+    }
+    if (tail_count == 0) {
+        tail_sum += var_quantile;
+        tail_count = 1;
+    }
+
+    RiskMetrics metrics;
+    metrics.var = -var_quantile;
+    metrics.cvar = -(tail_sum / static_cast<double>(tail_count));
+    return metrics;
+}
+
+// Likelihood-ratio weighted VaR and ES: the quantile is the lowest P&L at
+// which the weighted CDF sum(w 1{pnl <= x}) / n reaches q, ES the weighted mean
+// at or below it. The CDF is not normalized by the total weight: likelihood
+// ratios have mean one, and their sum over all rows is far noisier than over
+// the tail.
+RiskMetrics weighted_tail_metrics(std::span<const double> pnls, std::span<const double> weights, double q) {
+    std::vector<std::size_t> order(pnls.size());
+    for (std::size_t i = 0; i < order.size(); ++i) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+        return pnls[a] < pnls[b] || (pnls[a] == pnls[b] && a < b);
+    });
+
+    const double target = q * static_cast<double>(pnls.size());
+    double tail_weight = 0.0;
+    double tail_sum = 0.0;
+    std::size_t k = 0;
+    for (; k < order.size(); ++k) {
+        tail_weight += weights[order[k]];
+        tail_sum += weights[order[k]] * pnls[order[k]];
+        if (tail_weight >= target) {
+            break;
+        }
+    }
+    k = std::min(k, order.size() - 1);
+    const double var_quantile = pnls[order[k]];
+    // Ties with the quantile belong to the tail, as in tail_metrics.
+    for (std::size_t j = k + 1; j < order.size() && pnls[order[j]] == var_quantile; ++j) {
+        tail_weight += weights[order[j]];
+        tail_sum += weights[order[j]] * pnls[order[j]];
+    }
+
+    RiskMetrics metrics;
+    metrics.var = -var_quantile;
+    metrics.cvar = tail_weight > 0.0 ? -(tail_sum / tail_weight) : -var_quantile;
+    return metrics;
+}
+
+RiskMetrics metrics_of(std::span<const double> pnls, std::span<const double> weights, double q) {
+    if (weights.empty()) {
+        const auto index = static_cast<std::size_t>(std::floor(q * static_cast<double>(pnls.size() - 1)));
+        return tail_metrics(pnls, index);
+    }
+    return weighted_tail_metrics(pnls, weights, q);
+}
+
+// Standard errors from the metrics of `batches` contiguous batches of rows:
+// the sample deviation of the batch estimates over sqrt(batches).
+void batch_errors(std::span<const double> pnls,
+                  std::span<const double> weights,
+                  double q,
+                  std::size_t batches,
+                  RiskMetrics& metrics) {
+    const std::size_t pairs = pnls.size() / 2;
+    if (pairs < batches) {
+        return;
+    }
+    std::vector<RiskMetrics> batch(batches);
+    for (std::size_t b = 0; b < batches; ++b) {
+        const std::size_t begin = 2 * (b * pairs / batches);
+        const std::size_t end = b + 1 == batches ? pnls.size() : 2 * ((b + 1) * pairs / batches);
+        batch[b] = metrics_of(pnls.subspan(begin, end - begin),
+                              weights.empty() ? weights : weights.subspan(begin, end - begin),
+                              q);
+    }
+    double var_mean = 0.0;
+    double cvar_mean = 0.0;
+    for (const RiskMetrics& m : batch) {
+        var_mean += m.var;
+        cvar_mean += m.cvar;
+    }
+    const double count = static_cast<double>(batches);
+    var_mean /= count;
+    cvar_mean /= count;
+    double var_ss = 0.0;
+    double cvar_ss = 0.0;
+    for (const RiskMetrics& m : batch) {
+        var_ss += (m.var - var_mean) * (m.var - var_mean);
+        cvar_ss += (m.cvar - cvar_mean) * (m.cvar - cvar_mean);
+    }
+    metrics.var_stderr = std::sqrt(var_ss / (count - 1.0) / count);
+    metrics.cvar_stderr = std::sqrt(cvar_ss / (count - 1.0) / count);
+}
+
+// Scenario rows per parallel block: enough that a block of shocks fills about
+// half of a typical L2, a multiple of the GEMV row block, and never tiny.
+std::size_t default_block_rows(std::size_t factors) {
+    constexpr std::size_t kBlockBytes = 128 * 1024;
+    constexpr std::size_t kMinRows = 64;
+    const std::size_t rows = kBlockBytes / (factors * sizeof(double));
+    return std::max(kMinRows, rows - rows % 4);
+}
+
+} // namespace
+
+struct ScenarioRisk::Impl {
+    Impl(const InstrumentSoA& soa, const ScenarioSet& set, double alpha, const RevaluationOptions& options)
+        : scenarios(set),
+          prepared(soa, set.factors),
+          q(std::clamp(1.0 - alpha, 0.0, 1.0)),
+          mode(prepared.option_count() > 0 ? options.mode : RevaluationMode::Full),
+          threads(options.threads),
+          block_rows(options.block_rows > 0 ? options.block_rows : default_block_rows(set.factors)),
+          pruning(mode == RevaluationMode::Full && options.prune_tail && prepared.option_count() > 0) {
+        if (scenarios.weights && (pruning || mode == RevaluationMode::Hybrid)) {
+            throw std::invalid_argument("weighted scenarios do not support tail pruning or hybrid revaluation");
+        }
+        if (pruning || mode == RevaluationMode::Hybrid) {
+            bounds.emplace(prepared, scenarios.ranges, options.bound_nodes);
+        }
+        if (mode == RevaluationMode::DeltaGamma || mode == RevaluationMode::Hybrid) {
+            model.emplace(soa, scenarios.factors);
+        } else if (mode == RevaluationMode::Grid) {
+            grid.emplace(prepared, scenarios.ranges, options.grid_nodes);
+            grid_check_rows = options.grid_check_rows;
+            grid_stats.emplace(prepared, *grid, scenarios.rows, grid_check_rows);
+        }
+    }
+
+    // Full P&L of scattered rows, for the repricing passes of pruning and hybrid mode.
+    void reprice(std::span<const std::size_t> picked, std::span<double> out) const {
+        parallel_for(picked.size(), block_rows, threads, [&](std::size_t, std::size_t begin, std::size_t end) {
+            std::vector<double> scratch;
+            for (std::size_t i = begin; i < end; ++i) {
+                const std::span<const double> row = scenarios.block(picked[i], picked[i] + 1, scratch);
+                out[i] = prepared.revalue(row.data());
+            }
+        });
+    }
+
+    void extend(std::size_t from, std::size_t to);
+    RiskMetrics metrics(RevaluationStats& stats);
+
+    ScenarioSet scenarios;
+    PreparedPortfolio prepared;
+    double q;
+    RevaluationMode mode;
+    std::size_t threads;
+    std::size_t block_rows;
+    bool pruning;
+    std::optional<PnlBounds> bounds;
+    std::optional<DeltaGammaModel> model;
+    std::optional<PricingGrid> grid;
+    std::optional<GridRevaluer> grid_stats; // statistics of all rows priced so far
+    std::size_t grid_check_rows = 0;
+
+    std::size_t rows = 0;
+    // Per row: the P&L (equity part only under pruning, the Taylor
+    // approximation in hybrid mode), P&L bounds (pruning and hybrid mode) and
+    // likelihood ratio.
+    std::vector<double> pnls;
+    std::vector<double> lower;
+    std::vector<double> upper;
+    std::vector<double> weights;
+};
+
+void ScenarioRisk::Impl::extend(std::size_t from, std::size_t to) {
+    const std::size_t N = scenarios.factors;
+    pnls.resize(to, 0.0);
+    auto block_pnls = [&](std::size_t begin, std::size_t end) {
+        return std::span<double>(pnls.data() + begin, end - begin);
+    };
+    // parallel_for over [from, to), with row indices shifted back.
+    auto for_blocks = [&](const std::function<void(std::size_t, std::size_t, std::size_t)>& body) {
+        parallel_for(to - from, block_rows, threads, [&](std::size_t block, std::size_t begin, std::size_t end) {
+            body(block, from + begin, from + end);
+        });
+    };
+
+    if (pruning) {
+        lower.resize(to, 0.0);
+        upper.resize(to, 0.0);
+        for_blocks([&](std::size_t, std::size_t begin, std::size_t end) {
+            std::vector<double> scratch;
+            const std::span<const double> shocks = scenarios.block(begin, end, scratch);
+            prepared.equity_pnl(shocks, end - begin, block_pnls(begin, end));
+            for (std::size_t t = begin; t < end; ++t) {
+                bounds->option_bounds(shocks.data() + (t - begin) * N, lower[t], upper[t]);
+                lower[t] += pnls[t];
+                upper[t] += pnls[t];
+            }
+        });
+    } else if (model) {
+        if (bounds) {
+            lower.resize(to, 0.0);
+            upper.resize(to, 0.0);
+        }
+        for_blocks([&](std::size_t, std::size_t begin, std::size_t end) {
+            std::vector<double> scratch;
+            const std::span<const double> shocks = scenarios.block(begin, end, scratch);
+            model->pnl(shocks, end - begin, block_pnls(begin, end));
+            if (bounds) {
+                // Hybrid: bounds on the full P&L, equities exact.
+                std::vector<double> equity(end - begin);
+                prepared.equity_pnl(shocks, end - begin, equity);
+                for (std::size_t t = begin; t < end; ++t) {
+                    bounds->option_bounds(shocks.data() + (t - begin) * N, lower[t], upper[t]);
+                    lower[t] += equity[t - begin];
+                    upper[t] += equity[t - begin];
+                }
+            }
+        });
+    } else if (grid) {
+        const std::size_t blocks = (to - from + block_rows - 1) / block_rows;
+        std::vector<GridRevaluer> revaluers;
+        revaluers.reserve(blocks);
+        for (std::size_t b = 0; b < blocks; ++b) {
+            revaluers.emplace_back(prepared, *grid, scenarios.rows, grid_check_rows);
+        }
+        for_blocks([&](std::size_t block, std::size_t begin, std::size_t end) {
+            std::vector<double> scratch;
+            const std::span<const double> shocks = scenarios.block(begin, end, scratch);
+            prepared.equity_pnl(shocks, end - begin, block_pnls(begin, end));
+            for (std::size_t t = begin; t < end; ++t) {
+                pnls[t] += revaluers[block].option_pnl(t, shocks.data() + (t - begin) * N);
+            }
+        });
+        for (const GridRevaluer& revaluer : revaluers) {
+            grid_stats->merge(revaluer);
+        }
+    } else {
+        // Equities for each block in one GEMV; only options are revalued per row.
+        const bool has_options = prepared.option_count() > 0;
+        for_blocks([&](std::size_t, std::size_t begin, std::size_t end) {
+            std::vector<double> scratch;
+            const std::span<const double> shocks = scenarios.block(begin, end, scratch);
+            prepared.equity_pnl(shocks, end - begin, block_pnls(begin, end));
+            if (has_options) {
+                for (std::size_t t = begin; t < end; ++t) {
+                    pnls[t] += prepared.option_pnl(shocks.data() + (t - begin) * N);
+                }
+            }
+        });
+    }
+
+    if (scenarios.weights) {
+        weights.resize(to);
+        for_blocks([&](std::size_t, std::size_t begin, std::size_t end) {
+            scenarios.weights(begin, end, std::span<double>(weights.data() + begin, end - begin));
+        });
+    }
+    rows = to;
+}
+
+RiskMetrics ScenarioRisk::Impl::metrics(RevaluationStats& stats) {
+    auto reprice_rows = [this](std::span<const std::size_t> picked, std::span<double> out) { reprice(picked, out); };
+    if (pruning) {
+        // Candidates in scenario order, priced exactly as in full mode, so the
+        // tail sum adds the same values in the same order.
+        const std::vector<std::size_t> candidates = tail_candidates(lower, upper, q);
+        std::vector<double> candidate_pnls(candidates.size(), 0.0);
+        reprice(candidates, candidate_pnls);
+        stats.pruned_rows = rows - candidates.size();
+        const auto quantile_index = static_cast<std::size_t>(std::floor(q * static_cast<double>(rows - 1)));
+        return tail_metrics(candidate_pnls, quantile_index);
+    }
+
+    std::span<const double> priced = pnls;
+    std::vector<double> refined;
+    RiskMetrics metrics;
+    if (mode == RevaluationMode::Hybrid) {
+        // VaR and ES from the repriced scenarios alone, in scenario order, as
+        // under pruning; the Taylor values of the rest only feed the errors.
+        refined = pnls;
+        const std::vector<std::size_t> tail = refine_tail(refined, lower, upper, q, reprice_rows, stats);
+        std::vector<double> tail_pnls(tail.size());
+        for (std::size_t i = 0; i < tail.size(); ++i) {
+            tail_pnls[i] = refined[tail[i]];
+        }
+        priced = refined;
+        metrics = tail_metrics(tail_pnls, static_cast<std::size_t>(std::floor(q * static_cast<double>(rows - 1))));
+    } else {
+        if (grid_stats) {
+            stats = grid_stats->stats();
+        }
+        metrics = metrics_of(priced, weights, q);
+    }
+    if (scenarios.error_batches > 1) {
+        batch_errors(priced, weights, q, scenarios.error_batches, metrics);
+    }
+    return metrics;
+}
+
+ScenarioRisk::ScenarioRisk(const InstrumentSoA& soa,
+                           const ScenarioSet& scenarios,
+                           double alpha,
+                           const RevaluationOptions& options) {
+    if (scenarios.rows == 0 || scenarios.factors == 0 || !scenarios.block) {
+        throw std::invalid_argument("scenario set must have rows, factors and a block source");
+    }
+    if (scenarios.ranges.size() != scenarios.factors) {
+        throw std::invalid_argument("scenario set needs one shock range per factor");
+    }
+    impl_ = std::make_unique<Impl>(soa, scenarios, alpha, options);
+}
+
+ScenarioRisk::~ScenarioRisk() = default;
+
+void ScenarioRisk::extend(std::size_t rows) {
+    if (rows > impl_->scenarios.rows) {
+        throw std::out_of_range("ScenarioRisk::extend past the scenario set");
+    }
+    if (rows > impl_->rows) {
+        impl_->extend(impl_->rows, rows);
+    }
+}
+
+std::size_t ScenarioRisk::rows() const noexcept {
+    return impl_->rows;
+}
+
+RiskMetrics ScenarioRisk::metrics(RevaluationStats* stats) {
+    if (impl_->rows == 0) {
+        throw std::logic_error("ScenarioRisk::metrics needs at least one priced row");
+    }
+    RevaluationStats local_stats;
+    const RiskMetrics metrics = impl_->metrics(local_stats);
+    if (stats != nullptr) {
+        *stats = local_stats;
+        stats->option_lines = impl_->prepared.option_count();
+        stats->contracts = impl_->prepared.contract_count();
+    }
+    return metrics;
+}
+
+RiskMetrics scenario_risk(const InstrumentSoA& soa,
+                          const ScenarioSet& scenarios,
+                          double alpha,
+                          const RevaluationOptions& options,
+                          RevaluationStats* stats) {
+    ScenarioRisk risk(soa, scenarios, alpha, options);
+    risk.extend(scenarios.rows);
+    return risk.metrics(stats);
+}
+
+} // namespace risk
@@ -6,15 +6,18 @@
 #include <risk/eigen_stub.hpp>
 
 #include <algorithm>
+#include <cstdint>
 #include <exception>
 #include <iomanip>
 #include <optional>
+#include <span>
 #include <stdexcept>
 #include <string>
 #include <sstream>
 #include <utility>
 #include <vector>
 
+#include <risk/factor_cache.hpp>
 #include <risk/greeks.hpp>
 #include <risk/hvar.hpp>
 #include <risk/instrument.hpp>
@@ -23,77 +26,60 @@
 #include <risk/kdb_loader.hpp>
 #include <risk/market.hpp>
 #include <risk/mcvar.hpp>
+#include <risk/parallel.hpp>
 #include <risk/portfolio.hpp>
+#include <risk/statistics.hpp>
 #include <risk/universe.hpp>
 #include <risk/utils.hpp>
+#include <risk/vmath.hpp>
 
 namespace {
 
-Eigen::VectorXd compute_sample_mean(const std::vector<double>& shocks,
-                                    std::size_t scenarios,
-                                    std::size_t factors) {
-    if (scenarios == 0 || factors == 0) {
-        throw std::invalid_argument("compute_sample_mean requires positive dimensions");
-    }
-    if (shocks.size() != scenarios * factors) {
-        throw std::invalid_argument("shock matrix size mismatch for mean computation");
+// Part of the sample-moment cache key; bump it whenever the moment kernels or
+// the entry layout change, so entries written by older builds are not reused.
+constexpr std::uint64_t kSampleMomentsVersion = 1;
+
+// Sample mean and covariance of the shocks, looked up in the cache by the
+// content of the shock matrix and stored there after a miss.
+void sample_moments(const std::vector<double>& shocks,
+                    std::size_t scenarios,
+                    std::size_t factors,
+                    std::size_t threads,
+                    const risk::FactorCache* cache,
+                    Eigen::VectorXd& mean,
+                    Eigen::MatrixXd& cov) {
+    if (cache == nullptr) {
+        mean = risk::compute_sample_mean(shocks, scenarios, factors, threads);
+        cov = risk::compute_sample_covariance(shocks, mean, scenarios, factors, threads);
+        return;
     }
 
-    Eigen::VectorXd mean = Eigen::VectorXd::Zero(static_cast<Eigen::Index>(factors));
-    for (std::size_t t = 0; t < scenarios; ++t) {
-        const std::size_t offset = t * factors;
-        for (std::size_t i = 0; i < factors; ++i) {
-            mean(static_cast<Eigen::Index>(i)) += shocks[offset + i];
-        }
-    }
-    const double inv = 1.0 / static_cast<double>(scenarios);
-    for (std::size_t i = 0; i < factors; ++i) {
-        mean(static_cast<Eigen::Index>(i)) *= inv;
+    const risk::CacheKey key = risk::CacheKeyBuilder()
+                                   .add("sample-moments")
+                                   .add(kSampleMomentsVersion)
+                                   .add(static_cast<std::uint64_t>(scenarios))
+                                   .add(static_cast<std::uint64_t>(factors))
+                                   .add(std::span<const double>(shocks))
+                                   .key();
+    const auto n = static_cast<Eigen::Index>(factors);
+    if (const std::optional<risk::CacheEntry> entry = cache->load(key);
+        entry && entry->size() == 2 && entry->array(0).values.size() == factors &&
+        entry->array(1).values.size() == factors * factors) {
+        mean = Eigen::VectorXd(entry->array(0).values);
+        cov = Eigen::MatrixXd::Zero(n, n);
+        std::copy(entry->array(1).values.begin(), entry->array(1).values.end(), cov.values().begin());
+        spdlog::info("Loaded sample moments from cache entry {}.", key.hex());
+        return;
     }
-    return mean;
-}
 
-Eigen::MatrixXd compute_sample_covariance(const std::vector<double>& shocks,
-                                          const Eigen::VectorXd& mean,
-                                          std::size_t scenarios,
-                                          std::size_t factors) {
-    if (factors == 0) {
-        throw std::invalid_argument("compute_sample_covariance requires positive factors");
-    }
-    if (shocks.size() != scenarios * factors) {
-        throw std::invalid_argument("shock matrix size mismatch for covariance computation");
-    }
-    if (mean.size() != static_cast<Eigen::Index>(factors)) {
-        throw std::invalid_argument("mean vector dimension mismatch");
+    mean = risk::compute_sample_mean(shocks, scenarios, factors, threads);
+    cov = risk::compute_sample_covariance(shocks, mean, scenarios, factors, threads);
+    const risk::CacheArray arrays[] = {{1, factors, mean.values()}, {factors, factors, cov.values()}};
+    if (cache->store(key, arrays)) {
+        spdlog::info("Stored sample moments in cache entry {}.", key.hex());
+    } else {
+        spdlog::warn("Could not write sample moments to cache directory '{}'.", cache->directory());
     }
-
-    Eigen::MatrixXd cov = Eigen::MatrixXd::Zero(static_cast<Eigen::Index>(factors),
-                                                static_cast<Eigen::Index>(factors));
-    if (scenarios <= 1) {
-        return cov;
-    }
-
-    std::vector<double> diff(factors, 0.0);
-    for (std::size_t t = 0; t < scenarios; ++t) {
-        const std::size_t offset = t * factors;
-        for (std::size_t i = 0; i < factors; ++i) {
-            diff[i] = shocks[offset + i] - mean(static_cast<Eigen::Index>(i));
-        }
-        for (std::size_t i = 0; i < factors; ++i) {
-            for (std::size_t j = 0; j < factors; ++j) {
-                const double increment = diff[i] * diff[j];
-                cov(static_cast<Eigen::Index>(i), static_cast<Eigen::Index>(j)) += increment;
-            }
-        }
-    }
-
-    const double inv = 1.0 / static_cast<double>(scenarios - 1);
-    for (std::size_t i = 0; i < factors; ++i) {
-        for (std::size_t j = 0; j < factors; ++j) {
-            cov(static_cast<Eigen::Index>(i), static_cast<Eigen::Index>(j)) *= inv;
-        }
-    }
-    return cov;
 }
 
 } // namespace
@@ -107,6 +93,22 @@ int main(int argc, char** argv) {
     int kdb_port = 5000;
     std::string kdb_credentials;
     bool connect_to_kdb = false;
+    std::string math_mode = "exact";
+    std::string revaluation_mode = "full";
+    std::size_t grid_nodes = 256;
+    bool prune_tail = false;
+    std::size_t threads = 0;
+    std::string mc_sampler = "pseudo";
+    int mc_paths = 200000;
+    bool mc_antithetic = false;
+    double mc_tolerance = 0.0;
+    double mc_time_budget = 0.0;
+    bool mc_importance = false;
+    std::size_t mc_factors = 0;
+    std::string cache_dir;
+    std::size_t cache_max_mb = 4096;
+    std::string covariance_source = "sample";
+    double ewma_decay = 0.94;
 
     app.add_option("-p,--portfolio", portfolio_path, "Portfolio CSV path")->required();
     app.add_option("-m,--market", market_path, "Market closes CSV path")->required();
@@ -114,12 +116,92 @@ int main(int argc, char** argv) {
     app.add_option("--kdb-port", kdb_port, "KDB+ port number")->default_val(kdb_port);
     app.add_option("--kdb-auth", kdb_credentials, "KDB+ credentials in user:password form");
     app.add_flag("--connect-kdb", connect_to_kdb, "Connect to the configured KDB+ instance before processing");
+    app.add_option("--math-mode", math_mode, "Pricing transcendentals: exact (libm) or fast (SIMD polynomials)")
+        ->check(CLI::IsMember({"exact", "fast"}))
+        ->default_val(math_mode);
+    app.add_option("--revaluation",
+                   revaluation_mode,
+                   "Option revaluation: full (Black-Scholes per scenario), grid (spot ladder), "
+                   "delta-gamma (Taylor expansion) or hybrid (delta-gamma, tail repriced in full)")
+        ->check(CLI::IsMember({"full", "grid", "delta-gamma", "hybrid"}))
+        ->default_val(revaluation_mode);
+    app.add_option("--grid-nodes", grid_nodes, "Spot-ladder nodes per underlying in grid revaluation")
+        ->check(CLI::Range(std::size_t{2}, std::size_t{1} << 20))
+        ->default_val(grid_nodes);
+    app.add_option("--threads", threads, "Worker threads for scenario revaluation (0: one per hardware thread)")
+        ->default_val(threads);
+    app.add_option("--mc-sampler",
+                   mc_sampler,
+                   "Monte Carlo normals: pseudo (Philox stream per path) or sobol (scrambled Sobol points)")
+        ->check(CLI::IsMember({"pseudo", "sobol"}))
+        ->default_val(mc_sampler);
+    app.add_option("--mc-paths", mc_paths, "Monte Carlo path count (powers of two suit sobol)")
+        ->check(CLI::Range(1, 1 << 30))
+        ->default_val(mc_paths);
+    app.add_option("--mc-tolerance",
+                   mc_tolerance,
+                   "Adaptive Monte Carlo: add paths until the 95% CI half-width of VaR and ES is within this "
+                   "fraction of the estimate, up to --mc-paths (0: fixed path count)")
+        ->check(CLI::Range(0.0, 1.0))
+        ->default_val(mc_tolerance);
+    app.add_option("--mc-time-budget", mc_time_budget, "Adaptive Monte Carlo: time budget in seconds (0: none)")
+        ->check(CLI::Range(0.0, 1e9))
+        ->default_val(mc_time_budget);
+    app.add_flag("--mc-antithetic", mc_antithetic, "Monte Carlo: pair every path with its mirror image");
+    CLI::Option* importance_flag = app.add_flag("--mc-importance",
+                                                mc_importance,
+                                                "Monte Carlo: shift paths toward the portfolio's delta loss direction and "
+                                                "weight them by likelihood ratio");
+    app.add_option("--mc-factors",
+                   mc_factors,
+                   "Monte Carlo: simulate this many principal components plus idiosyncratic noise instead of the "
+                   "full Cholesky factor (0: full)")
+        ->default_val(mc_factors);
+    app.add_option("--covariance",
+                   covariance_source,
+                   "Monte Carlo mean and covariance: sample (equal weights; from KDB+ when connected) or ewma "
+                   "(exponentially weighted shocks)")
+        ->check(CLI::IsMember({"sample", "ewma"}))
+        ->default_val(covariance_source);
+    app.add_option("--ewma-decay", ewma_decay, "EWMA covariance: daily decay factor (RiskMetrics: 0.94)")
+        ->check(CLI::Range(0.5, 0.9999))
+        ->default_val(ewma_decay);
+    app.add_option("--cache-dir",
+                   cache_dir,
+                   "Directory caching sample moments, EWMA checkpoints and Monte Carlo covariance factors across "
+                   "runs (empty: off)");
+    app.add_option("--cache-max-mb",
+                   cache_max_mb,
+                   "Cache directory size limit in MiB; each write evicts least recently used entries beyond it "
+                   "(0: unlimited)")
+        ->default_val(cache_max_mb);
+    app.add_flag("--prune-tail", prune_tail, "Full HVaR: reprice only scenarios whose P&L bounds can reach the tail")
+        ->excludes(importance_flag);
 
     try {
         CLI11_PARSE(app, argc, argv);
 
         spdlog::set_level(spdlog::level::debug);
 
+        if (mc_tolerance > 0.0 && mc_paths < 40) {
+            spdlog::error("--mc-tolerance needs --mc-paths of at least 40 for batch-means confidence intervals");
+            return 1;
+        }
+        if (mc_importance && revaluation_mode == "hybrid") {
+            spdlog::error("--mc-importance cannot be combined with --revaluation hybrid");
+            return 1;
+        }
+
+        risk::vmath::set_math_mode(math_mode == "fast" ? risk::vmath::MathMode::Fast : risk::vmath::MathMode::Exact);
+        spdlog::info("Using {} math kernels for batch pricing.", math_mode);
+
+        std::optional<risk::FactorCache> factor_cache;
+        if (!cache_dir.empty()) {
+            factor_cache.emplace(cache_dir, static_cast<std::uintmax_t>(cache_max_mb) << 20U);
+            spdlog::info("Caching moments, EWMA checkpoints and covariance factors in '{}' (limit {} MiB).",
+                         cache_dir,
+                         cache_max_mb);
+        }
 
         std::optional<risk::kdb::Connection> kdb_connection;
         if (connect_to_kdb) {
@@ -168,11 +250,16 @@ int main(int argc, char** argv) {
                     throw std::runtime_error("KDB+ shock matrix has inconsistent dimensions");
                 }
 
-                mu = risk::kdb::load_sample_mean(kdb_connection->handle(), N);
-                cov = risk::kdb::load_sample_covariance(kdb_connection->handle(), N);
+                // EWMA moments are computed from the shocks below, so the
+                // precomputed sample moments are neither needed nor required.
+                if (covariance_source == "sample") {
+                    mu = risk::kdb::load_sample_mean(kdb_connection->handle(), N);
+                    cov = risk::kdb::load_sample_covariance(kdb_connection->handle(), N);
+                    spdlog::info("Loaded market, portfolio, and precomputed statistics from KDB+.");
+                } else {
+                    spdlog::info("Loaded market, portfolio, and shocks from KDB+.");
+                }
                 using_kdb_data = true;
-
-                spdlog::info("Loaded market, portfolio, and precomputed statistics from KDB+.");
             } catch (const std::exception& ex) {
                 spdlog::warn("KDB+ load failed: {}. Falling back to CSV inputs.", ex.what());
                 dates.clear();
@@ -186,7 +273,7 @@ int main(int argc, char** argv) {
         }
 
         if (!using_kdb_data) {
-            if (!risk::load_closes_csv(market_path, dates, prices_flat, T, N)) {
+            if (!risk::load_closes_csv(market_path, dates, prices_flat, T, N, risk::resolve_thread_count(threads))) {
                 return 1;
             }
             if (N != risk::universe_size()) {
@@ -211,8 +298,15 @@ int main(int argc, char** argv) {
                 return 1;
             }
 
-            mu = compute_sample_mean(shocks_flat, scenario_count, N);
-            cov = compute_sample_covariance(shocks_flat, mu, scenario_count, N);
+            if (covariance_source == "sample") {
+                sample_moments(shocks_flat,
+                               scenario_count,
+                               N,
+                               risk::resolve_thread_count(threads),
+                               factor_cache ? &*factor_cache : nullptr,
+                               mu,
+                               cov);
+            }
         } else {
             spdlog::debug("Loaded market data from KDB+ with {} rows and {} tickers.", T, N);
         }
@@ -230,6 +324,24 @@ int main(int argc, char** argv) {
             return 1;
         }
 
+        if (covariance_source == "ewma") {
+            std::size_t replayed = 0;
+            const risk::EwmaCovariance ewma = risk::ewma_covariance(shocks_flat,
+                                                                    scenario_count,
+                                                                    N,
+                                                                    ewma_decay,
+                                                                    factor_cache ? &*factor_cache : nullptr,
+                                                                    /*max_resume_days=*/64,
+                                                                    &replayed);
+            mu = ewma.mean();
+            cov = ewma.covariance();
+            spdlog::info("EWMA covariance (decay {}): streamed {} of {} days{}.",
+                         ewma_decay,
+                         replayed,
+                         scenario_count,
+                         replayed < scenario_count ? " after a cached checkpoint" : "");
+        }
+
         const auto& symbols = risk::universe_symbols();
 
         spdlog::info("Shock matrix by equity ({} scenarios per column):", scenario_count);
@@ -264,11 +376,56 @@ int main(int argc, char** argv) {
 
         const double alpha = 0.99;
 
+        risk::RevaluationOptions revaluation;
+        if (revaluation_mode == "grid") {
+            revaluation.mode = risk::RevaluationMode::Grid;
+        } else if (revaluation_mode == "delta-gamma") {
+            revaluation.mode = risk::RevaluationMode::DeltaGamma;
+        } else if (revaluation_mode == "hybrid") {
+            revaluation.mode = risk::RevaluationMode::Hybrid;
+        }
+        revaluation.grid_nodes = grid_nodes;
+        revaluation.prune_tail = prune_tail;
+        revaluation.threads = risk::resolve_thread_count(threads);
+        spdlog::info("Revaluing scenarios on {} worker threads.", revaluation.threads);
+
+        auto log_revaluation_stats = [](const char* label, const risk::RevaluationStats& stats) {
+            if (stats.pruned_rows > 0) {
+                spdlog::info("{} tail pruning: {} scenarios proven outside the tail.", label, stats.pruned_rows);
+            }
+            if (stats.full_rows > 0) {
+                spdlog::info("{} hybrid revaluation: {} scenarios repriced in full, max |delta-gamma error| {:.3e}, rms {:.3e}.",
+                             label,
+                             stats.full_rows,
+                             stats.max_abs_error,
+                             stats.rms_error);
+            }
+            if (stats.grid_nodes == 0) {
+                return;
+            }
+            spdlog::info("{} grid revaluation: {} nodes, {} fallback scenarios, max |error| {:.3e}, rms {:.3e} over {} checked.",
+                         label,
+                         stats.grid_nodes,
+                         stats.fallback_rows,
+                         stats.max_abs_error,
+                         stats.rms_error,
+                         stats.checked_rows);
+        };
+
+        risk::RevaluationStats hist_revaluation;
         const risk::RiskMetrics hist_metrics = risk::compute_hvar(portfolio,
                                                                   shocks_flat,
                                                                   scenario_count,
                                                                   N,
-                                                                  alpha);
+                                                                  alpha,
+                                                                  revaluation,
+                                                                  &hist_revaluation);
+        if (hist_revaluation.option_lines > 0) {
+            spdlog::info("Netted {} option lines into {} unique contracts.",
+                         hist_revaluation.option_lines,
+                         hist_revaluation.contracts);
+        }
+        log_revaluation_stats("HVaR", hist_revaluation);
 
         auto format_vector = [](const Eigen::VectorXd& vec) {
             std::ostringstream oss;
@@ -306,13 +463,80 @@ int main(int argc, char** argv) {
             spdlog::debug("  {}", format_matrix_row(cov, row));
         }
 
-        const risk::RiskMetrics mc_metrics = risk::compute_mcvar(portfolio,
-                                                                 mu,
-                                                                 cov,
-                                                                 /*horizon_days=*/1.0,
-                                                                 alpha,
-                                                                 /*paths=*/200000,
-                                                                 /*seed=*/123456789ULL);
+        risk::MonteCarloOptions sampling;
+        if (mc_sampler == "sobol") {
+            sampling.sampler = risk::MonteCarloSampler::Sobol;
+        }
+        sampling.antithetic = mc_antithetic;
+        sampling.importance_sampling = mc_importance;
+        sampling.pca_factors = mc_factors;
+        sampling.factor_cache = factor_cache ? &*factor_cache : nullptr;
+        risk::MonteCarloModel mc_model;
+        risk::RevaluationStats mc_revaluation;
+        risk::RiskMetrics mc_metrics;
+        if (mc_tolerance > 0.0) {
+            risk::AdaptiveMonteCarloOptions adaptive;
+            adaptive.tolerance = mc_tolerance;
+            adaptive.max_paths = mc_paths;
+            adaptive.initial_paths = std::min(adaptive.initial_paths, mc_paths);
+            adaptive.time_budget_seconds = mc_time_budget;
+            // Pruning needs the final tail up front, which adaptive runs never know.
+            risk::RevaluationOptions adaptive_revaluation = revaluation;
+            adaptive_revaluation.prune_tail = false;
+            spdlog::info("Simulating up to {} Monte Carlo paths with the {} sampler, stopping at {:.2f}% CI half-width.",
+                         mc_paths,
+                         mc_sampler,
+                         100.0 * mc_tolerance);
+            const risk::AdaptiveMonteCarloResult adaptive_result = risk::compute_mcvar_adaptive(portfolio,
+                                                                                               mu,
+                                                                                               cov,
+                                                                                               /*horizon_days=*/1.0,
+                                                                                               alpha,
+                                                                                               /*seed=*/123456789ULL,
+                                                                                               adaptive,
+                                                                                               adaptive_revaluation,
+                                                                                               &mc_revaluation,
+                                                                                               sampling);
+            mc_metrics = adaptive_result.metrics;
+            mc_model = adaptive_result.model;
+            spdlog::info("Adaptive MCVaR {} after {} paths in {:.3f}s: 95% CI half-width ${:.4f} (VaR), ${:.4f} (ES).",
+                         adaptive_result.converged ? "converged" : "stopped short of the tolerance",
+                         adaptive_result.paths,
+                         adaptive_result.elapsed_seconds,
+                         adaptive_result.var_half_width,
+                         adaptive_result.cvar_half_width);
+        } else {
+            spdlog::info("Simulating {} Monte Carlo paths with the {} sampler.", mc_paths, mc_sampler);
+            mc_metrics = risk::compute_mcvar(portfolio,
+                                             mu,
+                                             cov,
+                                             /*horizon_days=*/1.0,
+                                             alpha,
+                                             mc_paths,
+                                             /*seed=*/123456789ULL,
+                                             revaluation,
+                                             &mc_revaluation,
+                                             sampling,
+                                             &mc_model);
+        }
+        spdlog::info("MCVaR simulated the {} of {} universe factors the portfolio references ({} normals per path).",
+                     mc_model.factors,
+                     risk::universe_size(),
+                     mc_model.normals);
+        if (mc_model.cached) {
+            spdlog::info("MCVaR path factors loaded from the cache.");
+        }
+        if (mc_model.pca_factors > 0) {
+            spdlog::info("MCVaR factor model: {} principal components explain {:.2f}% of the variance.",
+                         mc_model.pca_factors,
+                         100.0 * mc_model.explained_variance);
+        } else {
+            spdlog::info("MCVaR covariance: rank {} of {}, condition number >= {:.3g}.",
+                         mc_model.rank,
+                         mc_model.factors,
+                         mc_model.condition);
+        }
+        log_revaluation_stats("MCVaR", mc_revaluation);
 
         std::vector<risk::bs::BSGreeks> greeks_per_contract;
         std::vector<risk::bs::BSGreeks> greeks_position;
@@ -384,6 +608,9 @@ int main(int argc, char** argv) {
         spdlog::info("==================== Monte Carlo ====================");
         spdlog::info("99% one-day MCVaR: ${:.4f}", mc_metrics.var);
         spdlog::info("99% one-day MCVaR (ES): ${:.4f}", mc_metrics.cvar);
+        if (mc_metrics.var_stderr > 0.0) {
+            spdlog::info("MCVaR standard error: ${:.4f} (VaR), ${:.4f} (ES)", mc_metrics.var_stderr, mc_metrics.cvar_stderr);
+        }
 
         spdlog::info("==================== Greeks ====================");
         std::string header = "Greek   |";
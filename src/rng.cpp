@@ -0,0 +1,33 @@
+#include <risk/rng.hpp>
+
+#include <risk/gaussian.hpp>
+
+namespace risk {
+
+namespace rng {
+
+void uniform_open(std::uint64_t seed, std::uint64_t stream, std::span<double> out) {
+    const PhiloxKey key{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)};
+    const auto stream_lo = static_cast<std::uint32_t>(stream);
+    const auto stream_hi = static_cast<std::uint32_t>(stream >> 32);
+    const std::size_t n = out.size();
+    const std::size_t pairs = n / 2;
+    for (std::size_t j = 0; j < pairs; ++j) {
+        const PhiloxCounter bits = philox4x32({static_cast<std::uint32_t>(j), stream_lo, stream_hi, 0U}, key);
+        out[2 * j] = to_unit_open((static_cast<std::uint64_t>(bits[0]) << 32) | bits[1]);
+        out[2 * j + 1] = to_unit_open((static_cast<std::uint64_t>(bits[2]) << 32) | bits[3]);
+    }
+    if (n % 2 != 0) {
+        const PhiloxCounter bits = philox4x32({static_cast<std::uint32_t>(pairs), stream_lo, stream_hi, 0U}, key);
+        out[n - 1] = to_unit_open((static_cast<std::uint64_t>(bits[0]) << 32) | bits[1]);
+    }
+}
+
+void path_normals(std::uint64_t seed, std::uint64_t path, std::span<double> out) {
+    uniform_open(seed, path, out);
+    normal_quantile(out, out);
+}
+
+} // namespace rng
+
+} // namespace risk
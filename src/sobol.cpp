@@ -0,0 +1,469 @@
+#include <risk/sobol.hpp>
+
+#include <bit>
+#include <iterator>
+#include <stdexcept>
+#include <vector>
+
+#include <risk/gaussian.hpp>
+#include <risk/rng.hpp>
+
+namespace risk {
+
+namespace rng {
+
+namespace {
+
+// Initial direction numbers m_1..m_s of dimensions 1 to 480 (the primitive
+// polynomials of degree up to 12), from S. Joe and F. Y. Kuo, new-joe-kuo-6.21201
+// (SIAM J. Sci. Comput. 30, 2008), chosen for good two-dimensional projections.
+// Listed in the order of primitive_polynomials(), s values per dimension.
+constexpr std::size_t kJoeKuoDimensions = 480;
+constexpr std::uint16_t kJoeKuoInitial[] = {
+    1, 1, 3, 1, 3, 1, 1, 1, 1, 1, 1, 3, 3, 1, 3, 5, 13, 1, 1, 5,
+    5, 17, 1, 1, 5, 5, 5, 1, 1, 7, 11, 19, 1, 1, 5, 1, 1, 1, 1, 1,
+    3, 11, 1, 3, 5, 5, 31, 1, 3, 3, 9, 7, 49, 1, 1, 1, 15, 21, 21, 1,
+    3, 1, 13, 27, 49, 1, 1, 1, 15, 7, 5, 1, 3, 1, 15, 13, 25, 1, 1, 5,
+    5, 19, 61, 1, 3, 7, 11, 23, 15, 103, 1, 3, 7, 13, 13, 15, 69, 1, 1, 3,
+    13, 7, 35, 63, 1, 3, 5, 9, 1, 25, 53, 1, 3, 1, 13, 9, 35, 107, 1, 3,
+    1, 5, 27, 61, 31, 1, 1, 5, 11, 19, 41, 61, 1, 3, 5, 3, 3, 13, 69, 1,
+    1, 7, 13, 1, 19, 1, 1, 3, 7, 5, 13, 19, 59, 1, 1, 3, 9, 25, 29, 41,
+    1, 3, 5, 13, 23, 1, 55, 1, 3, 7, 3, 13, 59, 17, 1, 3, 1, 3, 5, 53,
+    69, 1, 1, 5, 5, 23, 33, 13, 1, 1, 7, 7, 1, 61, 123, 1, 1, 7, 9, 13,
+    61, 49, 1, 3, 3, 5, 3, 55, 33, 1, 3, 1, 15, 31, 13, 49, 245, 1, 3, 5,
+    15, 31, 59, 63, 97, 1, 3, 1, 11, 11, 11, 77, 249, 1, 3, 1, 11, 27, 43, 71,
+    9, 1, 1, 7, 15, 21, 11, 81, 45, 1, 3, 7, 3, 25, 31, 65, 79, 1, 3, 1,
+    1, 19, 11, 3, 205, 1, 1, 5, 9, 19, 21, 29, 157, 1, 3, 7, 11, 1, 33, 89,
+    185, 1, 3, 3, 3, 15, 9, 79, 71, 1, 3, 7, 11, 15, 39, 119, 27, 1, 1, 3,
+    1, 11, 31, 97, 225, 1, 1, 1, 3, 23, 43, 57, 177, 1, 3, 7, 7, 17, 17, 37,
+    71, 1, 3, 1, 5, 27, 63, 123, 213, 1, 1, 3, 5, 11, 43, 53, 133, 1, 3, 5,
+    5, 29, 17, 47, 173, 479, 1, 3, 3, 11, 3, 1, 109, 9, 69, 1, 1, 1, 5, 17,
+    39, 23, 5, 343, 1, 3, 1, 5, 25, 15, 31, 103, 499, 1, 1, 1, 11, 11, 17, 63,
+    105, 183, 1, 1, 5, 11, 9, 29, 97, 231, 363, 1, 1, 5, 15, 19, 45, 41, 7, 383,
+    1, 3, 7, 7, 31, 19, 83, 137, 221, 1, 1, 1, 3, 23, 15, 111, 223, 83, 1, 1,
+    5, 13, 31, 15, 55, 25, 161, 1, 1, 3, 13, 25, 47, 39, 87, 257, 1, 1, 1, 11,
+    21, 53, 125, 249, 293, 1, 1, 7, 11, 11, 7, 57, 79, 323, 1, 1, 5, 5, 17, 13,
+    81, 3, 131, 1, 1, 7, 13, 23, 7, 65, 251, 475, 1, 3, 5, 1, 9, 43, 3, 149,
+    11, 1, 1, 3, 13, 31, 13, 13, 255, 487, 1, 3, 3, 1, 5, 63, 89, 91, 127, 1,
+    1, 3, 3, 1, 19, 123, 127, 237, 1, 1, 5, 7, 23, 31, 37, 243, 289, 1, 1, 5,
+    11, 17, 53, 117, 183, 491, 1, 1, 1, 5, 1, 13, 13, 209, 345, 1, 1, 3, 15, 1,
+    57, 115, 7, 33, 1, 3, 1, 11, 7, 43, 81, 207, 175, 1, 3, 1, 1, 15, 27, 63,
+    255, 49, 1, 3, 5, 3, 27, 61, 105, 171, 305, 1, 1, 5, 3, 1, 3, 57, 249, 149,
+    1, 1, 3, 5, 5, 57, 15, 13, 159, 1, 1, 1, 11, 7, 11, 105, 141, 225, 1, 3,
+    3, 5, 27, 59, 121, 101, 271, 1, 3, 5, 9, 11, 49, 51, 59, 115, 1, 1, 7, 1,
+    23, 45, 125, 71, 419, 1, 1, 3, 5, 23, 5, 105, 109, 75, 1, 1, 7, 15, 7, 11,
+    67, 121, 453, 1, 3, 7, 3, 9, 13, 31, 27, 449, 1, 3, 1, 15, 19, 39, 39, 89,
+    15, 1, 1, 1, 1, 1, 33, 73, 145, 379, 1, 3, 1, 15, 15, 43, 29, 13, 483, 1,
+    1, 7, 3, 19, 27, 85, 131, 431, 1, 3, 3, 3, 5, 35, 23, 195, 349, 1, 3, 3,
+    7, 9, 27, 39, 59, 297, 1, 1, 3, 9, 11, 17, 13, 241, 157, 1, 3, 7, 15, 25,
+    57, 33, 189, 213, 1, 1, 7, 1, 9, 55, 73, 83, 217, 1, 3, 3, 13, 19, 27, 23,
+    113, 249, 1, 3, 5, 3, 23, 43, 3, 253, 479, 1, 1, 5, 5, 11, 5, 45, 117, 217,
+    1, 3, 3, 7, 29, 37, 33, 123, 147, 1, 3, 1, 15, 5, 5, 37, 227, 223, 459, 1,
+    1, 7, 5, 5, 39, 63, 255, 135, 487, 1, 3, 1, 7, 9, 7, 87, 249, 217, 599, 1,
+    1, 3, 13, 9, 47, 7, 225, 363, 247, 1, 3, 7, 13, 19, 13, 9, 67, 9, 737, 1,
+    3, 5, 5, 19, 59, 7, 41, 319, 677, 1, 1, 5, 3, 31, 63, 15, 43, 207, 789, 1,
+    1, 7, 9, 13, 39, 3, 47, 497, 169, 1, 3, 1, 7, 21, 17, 97, 19, 415, 905, 1,
+    3, 7, 1, 3, 31, 71, 111, 165, 127, 1, 1, 5, 11, 1, 61, 83, 119, 203, 847, 1,
+    3, 3, 13, 9, 61, 19, 97, 47, 35, 1, 1, 7, 7, 15, 29, 63, 95, 417, 469, 1,
+    3, 1, 9, 25, 9, 71, 57, 213, 385, 1, 3, 5, 13, 31, 47, 101, 57, 39, 341, 1,
+    1, 3, 3, 31, 57, 125, 173, 365, 551, 1, 3, 7, 1, 13, 57, 67, 157, 451, 707, 1,
+    1, 1, 7, 21, 13, 105, 89, 429, 965, 1, 1, 5, 9, 17, 51, 45, 119, 157, 141, 1,
+    3, 7, 7, 13, 45, 91, 9, 129, 741, 1, 3, 7, 1, 23, 57, 67, 141, 151, 571, 1,
+    1, 3, 11, 17, 47, 93, 107, 375, 157, 1, 3, 3, 5, 11, 21, 43, 51, 169, 915, 1,
+    1, 5, 3, 15, 55, 101, 67, 455, 625, 1, 3, 5, 9, 1, 23, 29, 47, 345, 595, 1,
+    3, 7, 7, 5, 49, 29, 155, 323, 589, 1, 3, 3, 7, 5, 41, 127, 61, 261, 717, 1,
+    3, 7, 7, 17, 23, 117, 67, 129, 1009, 1, 1, 3, 13, 11, 39, 21, 207, 123, 305, 1,
+    1, 3, 9, 29, 3, 95, 47, 231, 73, 1, 3, 1, 9, 1, 29, 117, 21, 441, 259, 1,
+    3, 1, 13, 21, 39, 125, 211, 439, 723, 1, 1, 7, 3, 17, 63, 115, 89, 49, 773, 1,
+    3, 7, 13, 11, 33, 101, 107, 63, 73, 1, 1, 5, 5, 13, 57, 63, 135, 437, 177, 1,
+    1, 3, 7, 27, 63, 93, 47, 417, 483, 1, 1, 3, 1, 23, 29, 1, 191, 49, 23, 1,
+    1, 3, 15, 25, 55, 9, 101, 219, 607, 1, 3, 1, 7, 7, 19, 51, 251, 393, 307, 1,
+    3, 3, 3, 25, 55, 17, 75, 337, 3, 1, 1, 1, 13, 25, 17, 65, 45, 479, 413, 1,
+    1, 7, 7, 27, 49, 99, 161, 213, 727, 1, 3, 5, 1, 23, 5, 43, 41, 251, 857, 1,
+    3, 3, 7, 11, 61, 39, 87, 383, 835, 1, 1, 3, 15, 13, 7, 29, 7, 505, 923, 1,
+    3, 7, 1, 5, 31, 47, 157, 445, 501, 1, 1, 3, 7, 1, 43, 9, 147, 115, 605, 1,
+    3, 3, 13, 5, 1, 119, 211, 455, 1001, 1, 1, 3, 5, 13, 19, 3, 243, 75, 843, 1,
+    3, 7, 7, 1, 19, 91, 249, 357, 589, 1, 1, 1, 9, 1, 25, 109, 197, 279, 411, 1,
+    3, 1, 15, 23, 57, 59, 135, 191, 75, 1, 1, 5, 15, 29, 21, 39, 253, 383, 349, 1,
+    3, 3, 5, 19, 45, 61, 151, 199, 981, 1, 3, 5, 13, 9, 61, 107, 141, 141, 1, 1,
+    3, 1, 11, 27, 25, 85, 105, 309, 979, 1, 3, 3, 11, 19, 7, 115, 223, 349, 43, 1,
+    1, 7, 9, 21, 39, 123, 21, 275, 927, 1, 1, 7, 13, 15, 41, 47, 243, 303, 437, 1,
+    1, 1, 7, 7, 3, 15, 99, 409, 719, 1, 3, 3, 15, 27, 49, 113, 123, 113, 67, 469,
+    1, 3, 7, 11, 3, 23, 87, 169, 119, 483, 199, 1, 1, 5, 15, 7, 17, 109, 229, 179,
+    213, 741, 1, 1, 5, 13, 11, 17, 25, 135, 403, 557, 1433, 1, 3, 1, 1, 1, 61, 67,
+    215, 189, 945, 1243, 1, 1, 7, 13, 17, 33, 9, 221, 429, 217, 1679, 1, 1, 3, 11, 27,
+    3, 15, 93, 93, 865, 1049, 1, 3, 7, 7, 25, 41, 121, 35, 373, 379, 1547, 1, 3, 3,
+    9, 11, 35, 45, 205, 241, 9, 59, 1, 3, 1, 7, 3, 51, 7, 177, 53, 975, 89, 1,
+    1, 3, 5, 27, 1, 113, 231, 299, 759, 861, 1, 3, 3, 15, 25, 29, 5, 255, 139, 891,
+    2031, 1, 3, 1, 1, 13, 9, 109, 193, 419, 95, 17, 1, 1, 7, 9, 3, 7, 29, 41,
+    135, 839, 867, 1, 1, 7, 9, 25, 49, 123, 217, 113, 909, 215, 1, 1, 7, 3, 23, 15,
+    43, 133, 217, 327, 901, 1, 1, 3, 3, 13, 53, 63, 123, 477, 711, 1387, 1, 1, 3, 15,
+    7, 29, 75, 119, 181, 957, 247, 1, 1, 1, 11, 27, 25, 109, 151, 267, 99, 1461, 1, 3,
+    7, 15, 5, 5, 53, 145, 11, 725, 1501, 1, 3, 7, 1, 9, 43, 71, 229, 157, 607, 1835,
+    1, 3, 3, 13, 25, 1, 5, 27, 471, 349, 127, 1, 1, 1, 1, 23, 37, 9, 221, 269,
+    897, 1685, 1, 1, 3, 3, 31, 29, 51, 19, 311, 553, 1969, 1, 3, 7, 5, 5, 55, 17,
+    39, 475, 671, 1529, 1, 1, 7, 1, 1, 35, 47, 27, 437, 395, 1635, 1, 1, 7, 3, 13,
+    23, 43, 135, 327, 139, 389, 1, 3, 7, 3, 9, 25, 91, 25, 429, 219, 513, 1, 1, 3,
+    5, 13, 29, 119, 201, 277, 157, 2043, 1, 3, 5, 3, 29, 57, 13, 17, 167, 739, 1031, 1,
+    3, 3, 5, 29, 21, 95, 27, 255, 679, 1531, 1, 3, 7, 15, 9, 5, 21, 71, 61, 961,
+    1201, 1, 3, 5, 13, 15, 57, 33, 93, 459, 867, 223, 1, 1, 1, 15, 17, 43, 127, 191,
+    67, 177, 1073, 1, 1, 1, 15, 23, 7, 21, 199, 75, 293, 1611, 1, 3, 7, 13, 15, 39,
+    21, 149, 65, 741, 319, 1, 3, 7, 11, 23, 13, 101, 89, 277, 519, 711, 1, 3, 7, 15,
+    19, 27, 85, 203, 441, 97, 1895, 1, 3, 1, 3, 29, 25, 21, 155, 11, 191, 197, 1, 1,
+    7, 5, 27, 11, 81, 101, 457, 675, 1687, 1, 3, 1, 5, 25, 5, 65, 193, 41, 567, 781,
+    1, 3, 1, 5, 11, 15, 113, 77, 411, 695, 1111, 1, 1, 3, 9, 11, 53, 119, 171, 55,
+    297, 509, 1, 1, 1, 1, 11, 39, 113, 139, 165, 347, 595, 1, 3, 7, 11, 9, 17, 101,
+    13, 81, 325, 1733, 1, 3, 1, 1, 21, 43, 115, 9, 113, 907, 645, 1, 1, 7, 3, 9,
+    25, 117, 197, 159, 471, 475, 1, 3, 1, 9, 11, 21, 57, 207, 485, 613, 1661, 1, 1, 7,
+    7, 27, 55, 49, 223, 89, 85, 1523, 1, 1, 5, 3, 19, 41, 45, 51, 447, 299, 1355, 1,
+    3, 1, 13, 1, 33, 117, 143, 313, 187, 1073, 1, 1, 7, 7, 5, 11, 65, 97, 377, 377,
+    1501, 1, 3, 1, 1, 21, 35, 95, 65, 99, 23, 1239, 1, 1, 5, 9, 3, 37, 95, 167,
+    115, 425, 867, 1, 3, 3, 13, 1, 37, 27, 189, 81, 679, 773, 1, 1, 3, 11, 1, 61,
+    99, 233, 429, 969, 49, 1, 1, 1, 7, 25, 63, 99, 165, 245, 793, 1143, 1, 1, 5, 11,
+    11, 43, 55, 65, 71, 283, 273, 1, 1, 5, 5, 9, 3, 101, 251, 355, 379, 1611, 1, 1,
+    1, 15, 21, 63, 85, 99, 49, 749, 1335, 1, 1, 5, 13, 27, 9, 121, 43, 255, 715, 289,
+    1, 3, 1, 5, 27, 19, 17, 223, 77, 571, 1415, 1, 1, 5, 3, 13, 59, 125, 251, 195,
+    551, 1737, 1, 3, 3, 15, 13, 27, 49, 105, 389, 971, 755, 1, 3, 5, 15, 23, 43, 35,
+    107, 447, 763, 253, 1, 3, 5, 11, 21, 3, 17, 39, 497, 407, 611, 1, 1, 7, 13, 15,
+    31, 113, 17, 23, 507, 1995, 1, 1, 7, 15, 3, 15, 31, 153, 423, 79, 503, 1, 1, 7,
+    9, 19, 25, 23, 171, 505, 923, 1989, 1, 1, 5, 9, 21, 27, 121, 223, 133, 87, 697, 1,
+    1, 5, 5, 9, 19, 107, 99, 319, 765, 1461, 1, 1, 3, 3, 19, 25, 3, 101, 171, 729,
+    187, 1, 1, 3, 1, 13, 23, 85, 93, 291, 209, 37, 1, 1, 1, 15, 25, 25, 77, 253,
+    333, 947, 1073, 1, 1, 3, 9, 17, 29, 55, 47, 255, 305, 2037, 1, 3, 3, 9, 29, 63,
+    9, 103, 489, 939, 1523, 1, 3, 7, 15, 7, 31, 89, 175, 369, 339, 595, 1, 3, 7, 13,
+    25, 5, 71, 207, 251, 367, 665, 1, 3, 3, 3, 21, 25, 75, 35, 31, 321, 1603, 1, 1,
+    1, 9, 11, 1, 65, 5, 11, 329, 535, 1, 1, 5, 3, 19, 13, 17, 43, 379, 485, 383,
+    1, 3, 5, 13, 13, 9, 85, 147, 489, 787, 1133, 1, 3, 1, 1, 5, 51, 37, 129, 195,
+    297, 1783, 1, 1, 3, 15, 19, 57, 59, 181, 455, 697, 2033, 1, 3, 7, 1, 27, 9, 65,
+    145, 325, 189, 201, 1, 3, 1, 15, 31, 23, 19, 5, 485, 581, 539, 1, 1, 7, 13, 11,
+    15, 65, 83, 185, 847, 831, 1, 3, 5, 7, 7, 55, 73, 15, 303, 511, 1905, 1, 3, 5,
+    9, 7, 21, 45, 15, 397, 385, 597, 1, 3, 7, 3, 23, 13, 73, 221, 511, 883, 1265, 1,
+    1, 3, 11, 1, 51, 73, 185, 33, 975, 1441, 1, 3, 3, 9, 19, 59, 21, 39, 339, 37,
+    143, 1, 1, 7, 1, 31, 33, 19, 167, 117, 635, 639, 1, 1, 1, 3, 5, 13, 59, 83,
+    355, 349, 1967, 1, 1, 1, 5, 19, 3, 53, 133, 97, 863, 983, 1, 3, 1, 13, 9, 41,
+    91, 105, 173, 97, 625, 1, 1, 5, 3, 7, 49, 115, 133, 71, 231, 1063, 1, 1, 7, 5,
+    17, 43, 47, 45, 497, 547, 757, 1, 3, 5, 15, 21, 61, 123, 191, 249, 31, 631, 1, 3,
+    7, 9, 17, 7, 11, 185, 127, 169, 1951, 1, 1, 5, 13, 11, 11, 9, 49, 29, 125, 791,
+    1, 1, 1, 15, 31, 41, 13, 167, 273, 429, 57, 1, 3, 5, 3, 27, 7, 35, 209, 65,
+    265, 1393, 1, 3, 1, 13, 31, 19, 53, 143, 135, 9, 1021, 1, 1, 7, 13, 31, 5, 115,
+    153, 143, 957, 623, 1, 1, 5, 11, 25, 19, 29, 31, 297, 943, 443, 1, 3, 3, 5, 21,
+    11, 127, 81, 479, 25, 699, 1, 1, 3, 11, 25, 31, 97, 19, 195, 781, 705, 1, 1, 5,
+    5, 31, 11, 75, 207, 197, 885, 2037, 1, 1, 1, 11, 9, 23, 29, 231, 307, 17, 1497, 1,
+    1, 5, 11, 11, 43, 111, 233, 307, 523, 1259, 1, 1, 7, 5, 1, 21, 107, 229, 343, 933,
+    217, 1, 1, 1, 11, 3, 21, 125, 131, 405, 599, 1469, 1, 3, 5, 5, 9, 39, 33, 81,
+    389, 151, 811, 1, 1, 7, 7, 7, 1, 59, 223, 265, 529, 2021, 1, 3, 1, 3, 9, 23,
+    85, 181, 47, 265, 49, 1, 3, 5, 11, 19, 23, 9, 7, 157, 299, 1983, 1, 3, 1, 5,
+    15, 5, 21, 105, 29, 339, 1041, 1, 1, 1, 1, 5, 33, 65, 85, 111, 705, 479, 1, 1,
+    1, 7, 9, 35, 77, 87, 151, 321, 101, 1, 1, 5, 7, 17, 1, 51, 197, 175, 811, 1229,
+    1, 3, 3, 15, 23, 37, 85, 185, 239, 543, 731, 1, 3, 1, 7, 7, 55, 111, 109, 289,
+    439, 243, 1, 1, 7, 11, 17, 53, 35, 217, 259, 853, 1667, 1, 3, 1, 9, 1, 63, 87,
+    17, 73, 565, 1091, 1, 1, 3, 3, 11, 41, 1, 57, 295, 263, 1029, 1, 1, 5, 1, 27,
+    45, 109, 161, 411, 421, 1395, 1, 3, 5, 11, 25, 35, 47, 191, 339, 417, 1727, 1, 1, 5,
+    15, 21, 1, 93, 251, 351, 217, 1767, 1, 3, 3, 11, 3, 7, 75, 155, 313, 211, 491, 1,
+    3, 3, 5, 11, 9, 101, 161, 453, 913, 1067, 1, 1, 3, 1, 15, 45, 127, 141, 163, 727,
+    1597, 1, 3, 3, 7, 1, 33, 63, 73, 73, 341, 1691, 1, 3, 5, 13, 15, 39, 53, 235,
+    77, 99, 949, 1, 1, 5, 13, 31, 17, 97, 13, 215, 301, 1927, 1, 1, 7, 1, 1, 37,
+    91, 93, 441, 251, 1131, 1, 3, 7, 9, 25, 5, 105, 69, 81, 943, 1459, 1, 3, 7, 11,
+    31, 43, 13, 209, 27, 1017, 501, 1, 1, 7, 15, 1, 33, 31, 233, 161, 507, 387, 1, 3,
+    3, 5, 5, 53, 33, 177, 503, 627, 1927, 1, 1, 7, 11, 7, 61, 119, 31, 457, 229, 1875,
+    1, 1, 5, 15, 19, 5, 53, 201, 157, 885, 1057, 1, 3, 7, 9, 1, 35, 51, 113, 249,
+    425, 1009, 1, 3, 5, 7, 21, 53, 37, 155, 119, 345, 631, 1, 3, 5, 7, 15, 31, 109,
+    69, 503, 595, 1879, 1, 3, 3, 1, 25, 35, 65, 131, 403, 705, 503, 1, 3, 7, 7, 19,
+    33, 11, 153, 45, 633, 499, 1, 3, 3, 5, 11, 3, 29, 93, 487, 33, 703, 1, 1, 3,
+    15, 21, 53, 107, 179, 387, 927, 1757, 1, 1, 3, 7, 21, 45, 51, 147, 175, 317, 361, 1,
+    1, 1, 7, 7, 13, 15, 243, 269, 795, 1965, 1, 1, 3, 5, 19, 33, 57, 115, 443, 537,
+    627, 1, 3, 3, 9, 3, 39, 25, 61, 185, 717, 1049, 1, 3, 7, 3, 7, 37, 107, 153,
+    7, 269, 1581, 1, 1, 7, 3, 7, 41, 91, 41, 145, 489, 1245, 1, 1, 5, 9, 7, 7,
+    105, 81, 403, 407, 283, 1, 1, 7, 9, 27, 55, 29, 77, 193, 963, 949, 1, 1, 5, 3,
+    25, 51, 107, 63, 403, 917, 815, 1, 1, 7, 3, 7, 61, 19, 51, 457, 599, 535, 1, 3,
+    7, 1, 23, 51, 105, 153, 239, 215, 1847, 1, 1, 3, 5, 27, 23, 79, 49, 495, 45, 1935,
+    1, 1, 1, 11, 11, 47, 55, 133, 495, 999, 1461, 1, 1, 3, 15, 27, 51, 93, 17, 355,
+    763, 1675, 1, 3, 1, 3, 1, 3, 79, 119, 499, 17, 995, 1, 1, 1, 1, 15, 43, 45,
+    17, 167, 973, 799, 1, 1, 1, 3, 27, 49, 89, 29, 483, 913, 2023, 1, 1, 3, 3, 5,
+    11, 75, 7, 41, 851, 611, 1, 3, 1, 3, 7, 57, 39, 123, 257, 283, 507, 1, 3, 3,
+    11, 27, 23, 113, 229, 187, 299, 133, 1, 1, 3, 13, 9, 63, 101, 77, 451, 169, 337, 1,
+    3, 7, 3, 3, 59, 45, 195, 229, 415, 409, 1, 3, 5, 3, 11, 19, 71, 93, 43, 857,
+    369, 1, 3, 7, 9, 19, 33, 115, 19, 241, 703, 247, 1, 3, 5, 11, 5, 35, 21, 155,
+    463, 1005, 1073, 1, 3, 7, 3, 25, 15, 109, 83, 93, 69, 1189, 1, 3, 5, 7, 5, 21,
+    93, 133, 135, 167, 903, 1, 1, 7, 7, 3, 59, 121, 161, 285, 815, 1769, 3705, 1, 3, 1,
+    1, 3, 47, 103, 171, 381, 609, 185, 373, 1, 3, 3, 15, 23, 33, 107, 131, 441, 445, 689,
+    2059, 1, 3, 3, 11, 7, 53, 101, 167, 435, 803, 1255, 3781, 1, 1, 5, 11, 15, 59, 41,
+    19, 135, 835, 1263, 505, 1, 1, 7, 11, 21, 49, 23, 219, 127, 961, 1065, 385, 1, 3, 5,
+    15, 7, 47, 117, 217, 45, 731, 1639, 733, 1, 1, 7, 11, 27, 57, 91, 87, 81, 35, 1269,
+    1007, 1, 1, 3, 11, 15, 37, 53, 219, 193, 937, 1899, 3733, 1, 3, 5, 3, 13, 11, 27,
+    19, 199, 393, 965, 2195, 1, 3, 1, 3, 5, 1, 37, 173, 413, 1023, 553, 409, 1, 3, 1,
+    7, 15, 29, 123, 95, 255, 373, 1799, 3841, 1, 3, 5, 13, 21, 57, 51, 17, 511, 195, 1157,
+    1831, 1, 1, 1, 15, 29, 19, 7, 73, 295, 519, 587, 3523, 1, 1, 5, 13, 13, 35, 115,
+    191, 123, 535, 717, 1661, 1, 3, 3, 5, 23, 21, 47, 251, 379, 921, 1119, 297, 1, 3, 3,
+    9, 29, 53, 121, 201, 135, 193, 523, 2943, 1, 1, 1, 7, 29, 45, 125, 9, 99, 867, 425,
+    601, 1, 3, 1, 9, 13, 15, 67, 181, 109, 293, 1305, 3079, 1, 3, 3, 9, 5, 35, 15,
+    209, 305, 87, 767, 2795, 1, 3, 3, 11, 27, 57, 113, 123, 179, 643, 149, 523, 1, 1, 3,
+    15, 11, 17, 67, 223, 63, 657, 335, 3309, 1, 1, 1, 9, 25, 29, 109, 159, 39, 513, 571,
+    1761, 1, 1, 3, 1, 5, 63, 75, 19, 455, 601, 123, 691, 1, 1, 1, 3, 21, 5, 45,
+    169, 377, 513, 1951, 2565, 1, 1, 3, 11, 3, 33, 119, 69, 253, 907, 805, 1449, 1, 1, 5,
+    13, 31, 15, 17, 7, 499, 61, 687, 1867, 1, 3, 7, 11, 17, 33, 73, 77, 299, 243, 641,
+    2345, 1, 1, 7, 11, 9, 35, 31, 235, 359, 647, 379, 1161, 1, 3, 3, 15, 31, 25, 5,
+    67, 33, 45, 437, 4067, 1, 1, 3, 11, 7, 17, 37, 87, 333, 253, 1517, 2921, 1, 1, 7,
+    15, 7, 15, 107, 189, 153, 769, 1521, 3427, 1, 3, 5, 13, 5, 61, 113, 37, 293, 393, 113,
+    43, 1, 1, 1, 15, 29, 43, 107, 31, 167, 147, 301, 1021, 1, 1, 1, 13, 3, 1, 35,
+    93, 195, 181, 2027, 1491, 1, 3, 3, 3, 13, 33, 77, 199, 153, 221, 1699, 3671, 1, 3, 5,
+    13, 7, 49, 123, 155, 495, 681, 819, 809, 1, 3, 5, 15, 27, 61, 117, 189, 183, 887, 617,
+    4053, 1, 1, 1, 7, 31, 59, 125, 235, 389, 369, 447, 1039, 1, 3, 5, 1, 5, 39, 115,
+    89, 249, 377, 431, 3747, 1, 1, 1, 5, 7, 47, 59, 157, 77, 445, 699, 3439, 1, 1, 3,
+    5, 11, 21, 19, 75, 11, 599, 1575, 735, 1, 3, 5, 3, 19, 13, 41, 69, 199, 143, 1761,
+    3215, 1, 3, 5, 7, 19, 43, 25, 41, 41, 11, 1647, 2783, 1, 3, 1, 9, 19, 45, 111,
+    97, 405, 399, 457, 3219, 1, 1, 3, 1, 23, 15, 65, 121, 59, 985, 829, 2259, 1, 1, 3,
+    7, 17, 13, 107, 229, 75, 551, 1299, 2363, 1, 1, 5, 5, 21, 57, 23, 199, 509, 139, 2007,
+    3875, 1, 3, 1, 11, 19, 53, 15, 229, 215, 741, 695, 823, 1, 3, 7, 1, 29, 3, 17,
+    163, 417, 559, 549, 319, 1, 3, 1, 13, 17, 9, 47, 133, 365, 7, 1937, 1071, 1, 3, 5,
+    7, 19, 37, 55, 163, 301, 249, 689, 2327, 1, 3, 5, 13, 11, 23, 61, 205, 257, 377, 615,
+    1457, 1, 3, 5, 1, 23, 37, 13, 75, 331, 495, 579, 3367, 1, 1, 1, 9, 1, 23, 49,
+    129, 475, 543, 883, 2531, 1, 3, 1, 5, 23, 59, 51, 35, 343, 695, 219, 369, 1, 3, 3,
+    1, 27, 17, 63, 97, 71, 507, 1929, 613, 1, 1, 5, 1, 21, 31, 11, 109, 247, 409, 1817,
+    2173, 1, 1, 3, 15, 23, 9, 7, 209, 301, 23, 147, 1691, 1, 1, 7, 5, 5, 19, 37,
+    229, 249, 277, 1115, 2309, 1, 1, 1, 5, 5, 63, 5, 249, 285, 431, 343, 2467, 1, 1, 1,
+    11, 7, 45, 35, 75, 505, 537, 29, 2919, 1, 3, 5, 15, 11, 39, 15, 63, 263, 9, 199,
+    445, 1, 3, 3, 3, 27, 63, 53, 171, 227, 63, 1049, 827, 1, 1, 3, 13, 7, 11, 115,
+    183, 179, 937, 1785, 381, 1, 3, 1, 11, 13, 15, 107, 81, 53, 295, 1785, 3757, 1, 3, 3,
+    13, 11, 5, 109, 243, 3, 505, 323, 1373, 1, 3, 3, 11, 21, 51, 17, 177, 381, 937, 1263,
+    3889, 1, 3, 5, 9, 27, 25, 85, 193, 143, 573, 1189, 2995, 1, 3, 5, 11, 13, 9, 81,
+    21, 159, 953, 91, 1751, 1, 1, 3, 3, 27, 61, 11, 253, 391, 333, 1105, 635, 1, 3, 3,
+    15, 9, 57, 95, 81, 419, 735, 251, 1141, 1, 1, 5, 9, 31, 39, 59, 13, 319, 807, 1241,
+    2433, 1, 3, 3, 5, 27, 13, 107, 141, 423, 937, 2027, 3233, 1, 3, 3, 9, 9, 25, 125,
+    23, 443, 835, 1245, 847, 1, 1, 7, 15, 17, 17, 83, 107, 411, 285, 847, 1571, 1, 1, 3,
+    13, 29, 61, 37, 81, 349, 727, 1453, 1957, 1, 3, 7, 11, 31, 13, 59, 77, 273, 591, 1265,
+    1533, 1, 1, 7, 7, 13, 17, 25, 25, 187, 329, 347, 1473, 1, 3, 7, 7, 5, 51, 37,
+    99, 221, 153, 503, 2583, 1, 3, 1, 13, 19, 27, 11, 69, 181, 479, 1183, 3229, 1, 3, 3,
+    13, 23, 21, 103, 147, 323, 909, 947, 315, 1, 3, 1, 3, 23, 1, 31, 59, 93, 513, 45,
+    2271, 1, 3, 5, 1, 7, 43, 109, 59, 231, 41, 1515, 2385, 1, 3, 1, 5, 31, 57, 49,
+    223, 283, 1013, 11, 701, 1, 1, 5, 1, 19, 53, 55, 31, 31, 299, 495, 693, 1, 3, 3,
+    9, 5, 33, 77, 253, 427, 791, 731, 1019, 1, 3, 7, 11, 1, 9, 119, 203, 53, 877, 1707,
+    3499, 1, 1, 3, 7, 13, 39, 55, 159, 423, 113, 1653, 3455, 1, 1, 3, 5, 21, 47, 51,
+    59, 55, 411, 931, 251, 1, 3, 7, 3, 31, 25, 81, 115, 405, 239, 741, 455, 1, 1, 5,
+    1, 31, 3, 101, 83, 479, 491, 1779, 2225, 1, 3, 3, 3, 9, 37, 107, 161, 203, 503, 767,
+    3435, 1, 3, 7, 9, 1, 27, 61, 119, 233, 39, 1375, 4089, 1, 1, 5, 9, 1, 31, 45,
+    51, 369, 587, 383, 2813, 1, 3, 7, 5, 31, 7, 49, 119, 487, 591, 1627, 53, 1, 1, 7,
+    1, 9, 47, 1, 223, 369, 711, 1603, 1917, 1, 3, 5, 3, 21, 37, 111, 17, 483, 739, 1193,
+    2775, 1, 3, 3, 7, 17, 11, 51, 117, 455, 191, 1493, 3821, 1, 1, 5, 9, 23, 39, 99,
+    181, 343, 485, 99, 1931, 1, 3, 1, 7, 29, 49, 31, 71, 489, 527, 1763, 2909, 1, 1, 5,
+    11, 5, 5, 73, 189, 321, 57, 1191, 3685, 1, 1, 5, 15, 13, 45, 125, 207, 371, 415, 315,
+    983, 1, 3, 3, 5, 25, 59, 33, 31, 239, 919, 1859, 2709, 1, 3, 5, 13, 27, 61, 23,
+    115, 61, 413, 1275, 3559, 1, 3, 7, 15, 5, 59, 101, 81, 47, 967, 809, 3189, 1, 1, 5,
+    11, 31, 15, 39, 25, 173, 505, 809, 2677, 1, 1, 5, 9, 19, 13, 95, 89, 511, 127, 1395,
+    2935, 1, 1, 5, 5, 31, 45, 9, 57, 91, 303, 1295, 3215, 1, 3, 3, 3, 19, 15, 113,
+    187, 217, 489, 1285, 1803, 1, 1, 3, 1, 13, 29, 57, 139, 255, 197, 537, 2183, 1, 3, 1,
+    15, 11, 7, 53, 255, 467, 9, 757, 3167, 1, 3, 3, 15, 21, 13, 9, 189, 359, 323, 49,
+    333, 1, 3, 7, 11, 7, 37, 21, 119, 401, 157, 1659, 1069, 1, 1, 5, 7, 17, 33, 115,
+    229, 149, 151, 2027, 279, 1, 1, 5, 15, 5, 49, 77, 155, 383, 385, 1985, 945, 1, 3, 7,
+    3, 7, 55, 85, 41, 357, 527, 1715, 1619, 1, 1, 3, 1, 21, 45, 115, 21, 199, 967, 1581,
+    3807, 1, 1, 3, 7, 21, 39, 117, 191, 169, 73, 413, 3417, 1, 1, 1, 13, 1, 31, 57,
+    195, 231, 321, 367, 1027, 1, 3, 7, 3, 11, 29, 47, 161, 71, 419, 1721, 437, 1, 1, 7,
+    3, 11, 9, 43, 65, 157, 1, 1851, 823, 1, 1, 1, 5, 21, 15, 31, 101, 293, 299, 127,
+    1321, 1, 1, 7, 1, 27, 1, 11, 229, 241, 705, 43, 1475, 1, 3, 7, 1, 5, 15, 73,
+    183, 193, 55, 1345, 49, 1, 3, 3, 3, 19, 3, 55, 21, 169, 663, 1675, 137, 1, 1, 1,
+    13, 7, 21, 69, 67, 373, 965, 1273, 2279, 1, 1, 7, 7, 21, 23, 17, 43, 341, 845, 465,
+    3355, 1, 3, 5, 5, 25, 5, 81, 101, 233, 139, 359, 2057, 1, 1, 3, 11, 15, 39, 55,
+    3, 471, 765, 1143, 3941, 1, 1, 7, 15, 9, 57, 81, 79, 215, 433, 333, 3855, 1, 1, 5,
+    5, 19, 45, 83, 31, 209, 363, 701, 1303, 1, 3, 7, 5, 1, 13, 55, 163, 435, 807, 287,
+    2031, 1, 3, 3, 7, 3, 3, 17, 197, 39, 169, 489, 1769, 1, 1, 3, 5, 29, 43, 87,
+    161, 289, 339, 1233, 2353, 1, 3, 3, 9, 21, 9, 77, 1, 453, 167, 1643, 2227, 1, 1, 7,
+    1, 15, 7, 67, 33, 193, 241, 1031, 2339, 1, 3, 1, 11, 1, 63, 45, 65, 265, 661, 849,
+    1979, 1, 3, 1, 13, 19, 49, 3, 11, 159, 213, 659, 2839, 1, 3, 5, 11, 9, 29, 27,
+    227, 253, 449, 1403, 3427, 1, 1, 3, 1, 7, 3, 77, 143, 277, 779, 1499, 475, 1, 1, 1,
+    5, 11, 23, 87, 131, 393, 849, 193, 3189, 1, 3, 5, 11, 3, 3, 89, 9, 449, 243, 1501,
+    1739, 1, 3, 1, 9, 29, 29, 113, 15, 65, 611, 135, 3687,
+};
+static_assert(std::size(kJoeKuoInitial) == 5033, "Joe-Kuo table must hold m_1..m_s for each of its dimensions");
+
+// Polynomials over GF(2) as bit masks, bit k holding the coefficient of x^k.
+std::uint64_t mulmod(std::uint64_t a, std::uint64_t b, std::uint64_t poly, unsigned degree) {
+    std::uint64_t result = 0;
+    while (b != 0) {
+        if ((b & 1U) != 0) {
+            result ^= a;
+        }
+        b >>= 1U;
+        a <<= 1U;
+        if (((a >> degree) & 1U) != 0) {
+            a ^= poly;
+        }
+    }
+    return result;
+}
+
+std::uint64_t powmod_x(std::uint64_t exponent, std::uint64_t poly, unsigned degree) {
+    std::uint64_t result = 1;
+    std::uint64_t base = 2; // x
+    while (exponent != 0) {
+        if ((exponent & 1U) != 0) {
+            result = mulmod(result, base, poly, degree);
+        }
+        base = mulmod(base, base, poly, degree);
+        exponent >>= 1U;
+    }
+    return result;
+}
+
+// poly is primitive iff x has multiplicative order exactly 2^degree - 1.
+bool is_primitive(std::uint64_t poly, unsigned degree) {
+    const std::uint64_t order = (std::uint64_t{1} << degree) - 1;
+    if (powmod_x(order, poly, degree) != 1) {
+        return false;
+    }
+    std::uint64_t rest = order;
+    for (std::uint64_t factor = 2; factor * factor <= rest; ++factor) {
+        if (rest % factor != 0) {
+            continue;
+        }
+        if (powmod_x(order / factor, poly, degree) == 1) {
+            return false;
+        }
+        while (rest % factor == 0) {
+            rest /= factor;
+        }
+    }
+    return rest == 1 || powmod_x(order / rest, poly, degree) != 1;
+}
+
+// The first count primitive polynomials of degree >= 1, by degree then value.
+std::vector<std::uint64_t> primitive_polynomials(std::size_t count) {
+    std::vector<std::uint64_t> polys;
+    for (unsigned degree = 1; polys.size() < count; ++degree) {
+        if (degree >= 32) {
+            throw std::invalid_argument("Sobol dimension count exceeds the 32-bit direction numbers");
+        }
+        const std::uint64_t lead = std::uint64_t{1} << degree;
+        for (std::uint64_t poly = lead + 1; poly < 2 * lead && polys.size() < count; poly += 2) {
+            if (is_primitive(poly, degree)) {
+                polys.push_back(poly);
+            }
+        }
+    }
+    return polys;
+}
+
+// Bratley-Fox recurrence for the direction numbers v_k = m_k 2^(32-k) of one
+// dimension. The initial m_k are odd and below 2^k: Joe-Kuo's when given,
+// otherwise drawn from a fixed stream.
+void fill_directions(std::uint64_t poly, std::size_t dimension, const std::uint16_t* initial, std::uint32_t* v) {
+    constexpr std::size_t kBits = 32;
+    const auto degree = static_cast<std::size_t>(std::bit_width(poly) - 1);
+    std::uint32_t m[kBits];
+    const PhiloxKey key{0x50B01u, 0xD1CEu};
+    for (std::size_t k = 0; k < degree && k < kBits; ++k) {
+        if (initial != nullptr) {
+            m[k] = initial[k];
+            continue;
+        }
+        const PhiloxCounter bits = philox4x32({static_cast<std::uint32_t>(dimension), static_cast<std::uint32_t>(k), 0U, 0U}, key);
+        const std::uint32_t mask = (std::uint32_t{2} << k) - 1; // m_{k+1} < 2^(k+1)
+        m[k] = (bits[0] & mask) | 1U;
+    }
+    for (std::size_t k = degree; k < kBits; ++k) {
+        std::uint32_t value = m[k - degree] ^ (m[k - degree] << degree);
+        for (std::size_t j = 1; j < degree; ++j) {
+            if (((poly >> (degree - j)) & 1U) != 0) {
+                value ^= m[k - j] << j;
+            }
+        }
+        m[k] = value;
+    }
+    for (std::size_t k = 0; k < kBits; ++k) {
+        v[k] = m[k] << (kBits - 1 - k);
+    }
+}
+
+std::uint32_t reverse_bits(std::uint32_t x) noexcept {
+    x = ((x >> 1U) & 0x55555555U) | ((x & 0x55555555U) << 1U);
+    x = ((x >> 2U) & 0x33333333U) | ((x & 0x33333333U) << 2U);
+    x = ((x >> 4U) & 0x0F0F0F0FU) | ((x & 0x0F0F0F0FU) << 4U);
+    x = ((x >> 8U) & 0x00FF00FFU) | ((x & 0x00FF00FFU) << 8U);
+    return (x >> 16U) | (x << 16U);
+}
+
+// Each output bit is the input bit flipped by a function of the bits above it,
+// i.e. a random permutation of every dyadic subinterval (Owen's scramble).
+std::uint32_t owen_scramble(std::uint32_t x, std::uint32_t seed) noexcept {
+    x = reverse_bits(x);
+    x ^= x * 0x3D20ADEAU;
+    x += seed;
+    x *= (seed >> 16U) | 1U;
+    x ^= x * 0x05526C56U;
+    x ^= x * 0x53A22864U;
+    return reverse_bits(x);
+}
+
+} // namespace
+
+SobolSequence::SobolSequence(std::size_t dimensions, std::uint64_t seed)
+    : dimensions_(dimensions) {
+    if (dimensions == 0) {
+        throw std::invalid_argument("Sobol sequence requires at least one dimension");
+    }
+    directions_.assign(dimensions * kBits, 0U);
+    for (std::size_t k = 0; k < kBits; ++k) {
+        directions_[k] = std::uint32_t{1} << (kBits - 1 - k);
+    }
+    const std::vector<std::uint64_t> polys = primitive_polynomials(dimensions - 1);
+    std::size_t offset = 0;
+    for (std::size_t d = 1; d < dimensions; ++d) {
+        const std::uint16_t* initial = d <= kJoeKuoDimensions ? kJoeKuoInitial + offset : nullptr;
+        fill_directions(polys[d - 1], d, initial, directions_.data() + d * kBits);
+        offset += static_cast<std::size_t>(std::bit_width(polys[d - 1]) - 1);
+    }
+
+    const PhiloxKey key{static_cast<std::uint32_t>(seed), static_cast<std::uint32_t>(seed >> 32)};
+    scramble_.resize(dimensions);
+    for (std::size_t d = 0; d < dimensions; ++d) {
+        // Counter word 3 set keeps these draws apart from the path streams.
+        scramble_[d] = philox4x32({static_cast<std::uint32_t>(d), 0U, 0U, 1U}, key)[0];
+    }
+}
+
+void SobolSequence::uniforms(std::uint64_t begin, std::uint64_t end, std::span<double> out) const {
+    if (begin > end || end > kMaxPoints) {
+        throw std::out_of_range("Sobol point range exceeds the sequence");
+    }
+    const std::size_t rows = static_cast<std::size_t>(end - begin);
+    if (out.size() != rows * dimensions_) {
+        throw std::invalid_argument("Sobol output span must hold rows × dimensions values");
+    }
+    if (rows == 0) {
+        return;
+    }
+
+    // Point i is the XOR of the direction numbers selected by the bits of its
+    // Gray code; consecutive Gray codes differ in bit ctz(i).
+    std::vector<std::uint32_t> x(dimensions_, 0U);
+    const std::uint64_t gray = begin ^ (begin >> 1U);
+    for (std::size_t d = 0; d < dimensions_; ++d) {
+        const std::uint32_t* v = directions_.data() + d * kBits;
+        for (std::size_t k = 0; k < kBits; ++k) {
+            if (((gray >> k) & 1U) != 0) {
+                x[d] ^= v[k];
+            }
+        }
+    }
+
+    for (std::size_t r = 0; r < rows; ++r) {
+        if (r > 0) {
+            const auto bit = static_cast<std::size_t>(std::countr_zero(begin + r));
+            for (std::size_t d = 0; d < dimensions_; ++d) {
+                x[d] ^= directions_[d * kBits + bit];
+            }
+        }
+        double* row = out.data() + r * dimensions_;
+        for (std::size_t d = 0; d < dimensions_; ++d) {
+            row[d] = (static_cast<double>(owen_scramble(x[d], scramble_[d])) + 0.5) * 0x1p-32;
+        }
+    }
+}
+
+void SobolSequence::normals(std::uint64_t begin, std::uint64_t end, std::span<double> out) const {
+    uniforms(begin, end, out);
+    normal_quantile(out, out);
+}
+
+} // namespace rng
+
+} // namespace risk
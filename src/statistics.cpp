@@ -0,0 +1,394 @@
+#include <risk/statistics.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <risk/cholesky.hpp>
+#include <risk/parallel.hpp>
+
+namespace risk {
+
+namespace {
+
+constexpr std::size_t kMeanColumns = 512;
+constexpr std::size_t kCovarianceRows = 64;
+constexpr std::size_t kTransposeTile = 32;
+
+// Part of the EWMA checkpoint key; bump it whenever the update or the saved
+// state changes, so checkpoints written by older builds are not resumed.
+constexpr std::uint64_t kEwmaStateVersion = 1;
+
+// The full symmetric matrix scale * upper, as an Eigen-typed result.
+Eigen::MatrixXd mirrored(const linalg::Matrix& upper, double scale) {
+    const std::size_t n = upper.rows();
+    linalg::Matrix full(n, n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const double* source = upper.row(i).data();
+        double* target = full.row(i).data();
+        for (std::size_t j = i; j < n; ++j) {
+            target[j] = scale * source[j];
+            full(j, i) = target[j];
+        }
+    }
+    return Eigen::MatrixXd(std::move(full));
+}
+
+} // namespace
+
+Eigen::VectorXd compute_sample_mean(std::span<const double> shocks,
+                                    std::size_t scenarios,
+                                    std::size_t factors,
+                                    std::size_t threads) {
+    if (scenarios == 0 || factors == 0) {
+        throw std::invalid_argument("compute_sample_mean requires positive dimensions");
+    }
+    if (shocks.size() != scenarios * factors) {
+        throw std::invalid_argument("shock matrix size mismatch for mean computation");
+    }
+
+    Eigen::VectorXd mean = Eigen::VectorXd::Zero(static_cast<Eigen::Index>(factors));
+    double* sums = mean.data();
+    const double inv = 1.0 / static_cast<double>(scenarios);
+    parallel_for(factors, kMeanColumns, threads, [&](std::size_t, std::size_t i0, std::size_t i1) {
+        for (std::size_t t = 0; t < scenarios; ++t) {
+            const double* row = shocks.data() + t * factors;
+            for (std::size_t i = i0; i < i1; ++i) {
+                sums[i] += row[i];
+            }
+        }
+        for (std::size_t i = i0; i < i1; ++i) {
+            sums[i] *= inv;
+        }
+    });
+    return mean;
+}
+
+Eigen::MatrixXd compute_sample_covariance(std::span<const double> shocks,
+                                          const Eigen::VectorXd& mean,
+                                          std::size_t scenarios,
+                                          std::size_t factors,
+                                          std::size_t threads) {
+    if (factors == 0) {
+        throw std::invalid_argument("compute_sample_covariance requires positive factors");
+    }
+    if (shocks.size() != scenarios * factors) {
+        throw std::invalid_argument("shock matrix size mismatch for covariance computation");
+    }
+    if (mean.size() != static_cast<Eigen::Index>(factors)) {
+        throw std::invalid_argument("mean vector dimension mismatch");
+    }
+
+    if (scenarios <= 1) {
+        return Eigen::MatrixXd::Zero(static_cast<Eigen::Index>(factors), static_cast<Eigen::Index>(factors));
+    }
+
+    const std::span<const double> centre = mean.values();
+
+    // D (scenarios x factors) and D^T, so both gemm operands are row-major.
+    AlignedVector<double> d(scenarios * factors);
+    AlignedVector<double> d_t(factors * scenarios);
+    parallel_for(scenarios, kTransposeTile, threads, [&](std::size_t, std::size_t t0, std::size_t t1) {
+        for (std::size_t i0 = 0; i0 < factors; i0 += kTransposeTile) {
+            const std::size_t i1 = std::min(factors, i0 + kTransposeTile);
+            for (std::size_t t = t0; t < t1; ++t) {
+                for (std::size_t i = i0; i < i1; ++i) {
+                    const double x = shocks[t * factors + i] - centre[i];
+                    d[t * factors + i] = x;
+                    d_t[i * scenarios + t] = x;
+                }
+            }
+        }
+    });
+
+    // Row block [r0, r1) of the upper triangle: C[r0:r1, r0:] = D^T[r0:r1, :] D[:, r0:].
+    linalg::Matrix product(factors, factors);
+    double* c = product.values().data();
+    parallel_for(factors, kCovarianceRows, threads, [&](std::size_t, std::size_t r0, std::size_t r1) {
+        linalg::gemm_strided(d_t.data() + r0 * scenarios,
+                             scenarios,
+                             d.data() + r0,
+                             factors,
+                             c + r0 * factors + r0,
+                             factors,
+                             r1 - r0,
+                             scenarios,
+                             factors - r0);
+    });
+
+    const double inv = 1.0 / static_cast<double>(scenarios - 1);
+    for (std::size_t i = 0; i < factors; ++i) {
+        for (std::size_t j = i; j < factors; ++j) {
+            const double value = c[i * factors + j] * inv;
+            c[i * factors + j] = value;
+            c[j * factors + i] = value;
+        }
+    }
+    return Eigen::MatrixXd(std::move(product));
+}
+
+RollingMoments::RollingMoments(std::size_t factors)
+    : factors_(factors), mean_(factors, 0.0), scatter_(factors, factors), delta_(factors) {
+    if (factors == 0) {
+        throw std::invalid_argument("RollingMoments requires positive factors");
+    }
+}
+
+RollingMoments::RollingMoments(std::span<const double> shocks,
+                               std::size_t scenarios,
+                               std::size_t factors,
+                               std::size_t threads)
+    : RollingMoments(factors) {
+    const Eigen::VectorXd mean = compute_sample_mean(shocks, scenarios, factors, threads);
+    *this = RollingMoments(mean, compute_sample_covariance(shocks, mean, scenarios, factors, threads), scenarios);
+}
+
+RollingMoments::RollingMoments(const Eigen::VectorXd& mean, const Eigen::MatrixXd& covariance, std::size_t count)
+    : RollingMoments(static_cast<std::size_t>(mean.size())) {
+    const auto n = static_cast<Eigen::Index>(factors_);
+    if (covariance.rows() != n || covariance.cols() != n) {
+        throw std::invalid_argument("RollingMoments covariance dimension mismatch");
+    }
+    count_ = count;
+    const double rows = count > 1 ? static_cast<double>(count - 1) : 0.0;
+    for (std::size_t i = 0; i < factors_; ++i) {
+        mean_[i] = count > 0 ? mean.values()[i] : 0.0;
+        const std::span<const double> source = covariance.row(static_cast<Eigen::Index>(i));
+        double* target = scatter_.row(i).data();
+        for (std::size_t j = i; j < factors_; ++j) {
+            target[j] = rows * source[j];
+        }
+    }
+}
+
+void RollingMoments::check_row(std::span<const double> row) const {
+    if (row.size() != factors_) {
+        throw std::invalid_argument("RollingMoments row length mismatch");
+    }
+}
+
+// Welford: with n rows after the push, the mean moves by delta / n and S gains
+// ((n - 1) / n) delta delta^T for delta = row - old mean.
+void RollingMoments::push(std::span<const double> row) {
+    check_row(row);
+    ++count_;
+    const double n = static_cast<double>(count_);
+    const double scale = std::sqrt((n - 1.0) / n);
+    for (std::size_t i = 0; i < factors_; ++i) {
+        const double delta = row[i] - mean_[i];
+        mean_[i] += delta / n;
+        delta_[i] = scale * delta;
+    }
+    for (std::size_t i = 0; i < factors_; ++i) {
+        double* s = scatter_.row(i).data();
+        const double di = delta_[i];
+        for (std::size_t j = i; j < factors_; ++j) {
+            s[j] += di * delta_[j];
+        }
+    }
+    if (has_factor_) {
+        linalg::cholesky_update(scatter_factor_, delta_);
+    }
+}
+
+// The push in reverse: with n rows before the pop, the mean without the row is
+// (n mean - row) / (n - 1), and S loses ((n - 1) / n) delta delta^T for delta =
+// row - that mean.
+void RollingMoments::pop(std::span<const double> row) {
+    check_row(row);
+    if (count_ == 0) {
+        throw std::invalid_argument("RollingMoments::pop on an empty window");
+    }
+    const double n = static_cast<double>(count_);
+    --count_;
+    if (count_ == 0) {
+        std::fill(mean_.begin(), mean_.end(), 0.0);
+        scatter_ = linalg::Matrix(factors_, factors_);
+        has_factor_ = false;
+        return;
+    }
+    const double scale = std::sqrt((n - 1.0) / n);
+    for (std::size_t i = 0; i < factors_; ++i) {
+        mean_[i] = (n * mean_[i] - row[i]) / (n - 1.0);
+        delta_[i] = scale * (row[i] - mean_[i]);
+    }
+    for (std::size_t i = 0; i < factors_; ++i) {
+        double* s = scatter_.row(i).data();
+        const double di = delta_[i];
+        for (std::size_t j = i; j < factors_; ++j) {
+            s[j] -= di * delta_[j];
+        }
+    }
+    // Rows centred on their own mean span at most count - 1 dimensions.
+    if (has_factor_ && (count_ <= factors_ || !linalg::cholesky_downdate(scatter_factor_, delta_))) {
+        has_factor_ = false;
+    }
+}
+
+Eigen::VectorXd RollingMoments::mean_vector() const {
+    return Eigen::VectorXd(std::span<const double>(mean_));
+}
+
+Eigen::MatrixXd RollingMoments::covariance() const {
+    if (count_ <= 1) {
+        const auto n = static_cast<Eigen::Index>(factors_);
+        return Eigen::MatrixXd::Zero(n, n);
+    }
+    return mirrored(scatter_, 1.0 / static_cast<double>(count_ - 1));
+}
+
+bool RollingMoments::factorize(std::size_t threads) {
+    has_factor_ = false;
+    if (count_ <= factors_) {
+        return false;
+    }
+    linalg::Matrix lower(factors_, factors_);
+    for (std::size_t i = 0; i < factors_; ++i) {
+        for (std::size_t j = 0; j <= i; ++j) {
+            lower(i, j) = scatter_(j, i);
+        }
+    }
+    try {
+        scatter_factor_ = linalg::cholesky(lower, threads);
+    } catch (const std::invalid_argument&) {
+        return false;
+    }
+    has_factor_ = true;
+    return true;
+}
+
+linalg::Matrix RollingMoments::covariance_factor() const {
+    if (!has_factor_) {
+        throw std::logic_error("RollingMoments has no covariance factor; call factorize()");
+    }
+    linalg::Matrix factor = scatter_factor_;
+    const double scale = 1.0 / std::sqrt(static_cast<double>(count_ - 1));
+    for (double& v : factor.values()) {
+        v *= scale;
+    }
+    return factor;
+}
+
+EwmaCovariance::EwmaCovariance(std::size_t factors, double decay)
+    : factors_(factors), decay_(decay), mean_(factors, 0.0), covariance_(factors, factors), delta_(factors) {
+    if (factors == 0) {
+        throw std::invalid_argument("EwmaCovariance requires positive factors");
+    }
+    if (!(decay > 0.0 && decay < 1.0)) {
+        throw std::invalid_argument("EwmaCovariance decay must lie in (0, 1)");
+    }
+}
+
+void EwmaCovariance::update(std::span<const double> row) {
+    if (row.size() != factors_) {
+        throw std::invalid_argument("EwmaCovariance row length mismatch");
+    }
+    if (days_++ == 0) {
+        std::copy(row.begin(), row.end(), mean_.begin());
+        return;
+    }
+    const double weight = 1.0 - decay_;
+    for (std::size_t i = 0; i < factors_; ++i) {
+        delta_[i] = row[i] - mean_[i];
+        mean_[i] += weight * delta_[i];
+    }
+    for (std::size_t i = 0; i < factors_; ++i) {
+        double* c = covariance_.row(i).data();
+        const double di = weight * delta_[i];
+        for (std::size_t j = i; j < factors_; ++j) {
+            c[j] = decay_ * (c[j] + di * delta_[j]);
+        }
+    }
+}
+
+Eigen::VectorXd EwmaCovariance::mean() const {
+    return Eigen::VectorXd(std::span<const double>(mean_));
+}
+
+Eigen::MatrixXd EwmaCovariance::covariance() const {
+    return mirrored(covariance_, 1.0);
+}
+
+// Entry layout: [decay, days], mean, covariance (upper triangle significant).
+bool EwmaCovariance::save(const FactorCache& cache, const CacheKey& key) const {
+    const double header[] = {decay_, static_cast<double>(days_)};
+    const CacheArray arrays[] = {
+        {1, 2, header},
+        {1, factors_, mean_},
+        {factors_, factors_, covariance_.values()},
+    };
+    return cache.store(key, arrays);
+}
+
+std::optional<EwmaCovariance> EwmaCovariance::restore(const FactorCache& cache, const CacheKey& key) {
+    const std::optional<CacheEntry> entry = cache.load(key);
+    if (!entry || entry->size() != 3 || entry->array(0).values.size() != 2) {
+        return std::nullopt;
+    }
+    const std::span<const double> header = entry->array(0).values;
+    const std::span<const double> mean = entry->array(1).values;
+    const std::span<const double> covariance = entry->array(2).values;
+    const std::size_t factors = mean.size();
+    if (factors == 0 || covariance.size() != factors * factors || !(header[0] > 0.0 && header[0] < 1.0)) {
+        return std::nullopt;
+    }
+    EwmaCovariance state(factors, header[0]);
+    state.days_ = static_cast<std::size_t>(header[1]);
+    std::copy(mean.begin(), mean.end(), state.mean_.begin());
+    std::copy(covariance.begin(), covariance.end(), state.covariance_.values().begin());
+    return state;
+}
+
+EwmaCovariance ewma_covariance(std::span<const double> shocks,
+                               std::size_t scenarios,
+                               std::size_t factors,
+                               double decay,
+                               const FactorCache* cache,
+                               std::size_t max_resume_days,
+                               std::size_t* replayed) {
+    if (shocks.size() != scenarios * factors) {
+        throw std::invalid_argument("shock matrix size mismatch for EWMA covariance");
+    }
+    EwmaCovariance state(factors, decay);
+    const auto row = [&](std::size_t t) { return shocks.subspan(t * factors, factors); };
+
+    // keys[d - first]: checkpoint key after the first d days.
+    const std::size_t first = scenarios - std::min(scenarios, max_resume_days);
+    std::vector<CacheKey> keys;
+    if (cache != nullptr) {
+        CacheKeyBuilder builder;
+        builder.add("ewma-state").add(kEwmaStateVersion).add(decay).add(static_cast<std::uint64_t>(factors));
+        for (std::size_t d = 0; d <= scenarios; ++d) {
+            if (d >= first) {
+                keys.push_back(builder.key());
+            }
+            if (d < scenarios) {
+                builder.add(row(d));
+            }
+        }
+        for (std::size_t d = scenarios + 1; d-- > std::max<std::size_t>(first, 1);) {
+            std::optional<EwmaCovariance> resumed = EwmaCovariance::restore(*cache, keys[d - first]);
+            if (resumed && resumed->days() == d && resumed->factors() == factors && resumed->decay() == decay) {
+                state = std::move(*resumed);
+                break;
+            }
+        }
+    }
+
+    const std::size_t start = state.days();
+    for (std::size_t t = start; t < scenarios; ++t) {
+        state.update(row(t));
+    }
+    if (cache != nullptr && start < scenarios) {
+        state.save(*cache, keys.back());
+    }
+    if (replayed != nullptr) {
+        *replayed = scenarios - start;
+    }
+    return state;
+}
+
+} // namespace risk
@@ -0,0 +1,140 @@
+#include <risk/tail_bounds.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace risk {
+
+namespace {
+
+// Relative slack on the bounds: far above double rounding and
+// kFastRevalueTolerance, far below the spacing of any useful ladder.
+constexpr double kBoundSlack = 1e-9;
+
+// Shocks at or below -1 price every option at zero, which breaks convexity in
+// the shock; the ladder starts just above and such scenarios stay unbounded.
+constexpr double kMinShock = -1.0 + 1e-9;
+
+} // namespace
+
+PnlBounds::PnlBounds(const PreparedPortfolio& prepared, std::span<const ShockRange> ranges, std::size_t nodes)
+    : nodes_(nodes) {
+    if (nodes < 2) {
+        throw std::invalid_argument("P&L bounds need at least two nodes");
+    }
+    if (ranges.size() != prepared.factor_count()) {
+        throw std::invalid_argument("shock ranges must cover every factor");
+    }
+
+    const PreparedOptions& calls = prepared.calls();
+    const PreparedOptions& puts = prepared.puts();
+    value_today_ = calls.value_today + puts.value_today;
+
+    constexpr std::size_t kUnused = std::numeric_limits<std::size_t>::max();
+    std::vector<std::size_t> slot(prepared.factor_count(), kUnused);
+    for (const PreparedOptions* options : {&calls, &puts}) {
+        for (std::uint32_t factor : options->factor) {
+            if (slot[factor] != kUnused) {
+                continue;
+            }
+            const ShockRange range = ranges[factor];
+            if (!(std::isfinite(range.lo) && std::isfinite(range.hi) && range.lo <= range.hi)) {
+                throw std::invalid_argument("shock range must be finite with lo <= hi");
+            }
+            const double lo = std::max(range.lo, kMinShock);
+            const double hi = std::max(range.hi, lo);
+            slot[factor] = factors_.size();
+            factors_.push_back(factor);
+            lo_.push_back(lo);
+            hi_.push_back(hi);
+            step_.push_back((hi - lo) / static_cast<double>(nodes - 1));
+        }
+    }
+
+    convex_.assign(factors_.size() * nodes, 0.0);
+    convex_slope_.assign(factors_.size() * nodes, 0.0);
+    concave_.assign(factors_.size() * nodes, 0.0);
+    concave_slope_.assign(factors_.size() * nodes, 0.0);
+    double scale = std::abs(value_today_);
+    for (const PreparedOptions* options : {&calls, &puts}) {
+        const bool is_call = options == &calls;
+        for (std::size_t j = 0; j < options->size(); ++j) {
+            const std::size_t f = slot[options->factor[j]];
+            const double qty = options->qty[j];
+            const double spot_today = options->spot[j];
+            AlignedVector<double>& value = qty >= 0.0 ? convex_ : concave_;
+            AlignedVector<double>& slope = qty >= 0.0 ? convex_slope_ : concave_slope_;
+            for (std::size_t k = 0; k < nodes; ++k) {
+                const double x = node(f, k);
+                const ContractValue v = contract_value(*options, j, spot_today * (1.0 + x), is_call);
+                value[f * nodes + k] += qty * v.price;
+                slope[f * nodes + k] += qty * v.delta * spot_today;
+            }
+            scale += std::abs(qty) * (spot_today * (1.0 + std::abs(hi_[f])) + options->disc_strike[j]);
+        }
+    }
+    slack_ = kBoundSlack * scale;
+}
+
+double PnlBounds::node(std::size_t f, std::size_t k) const {
+    // The last node is hi exactly so the ladder cannot stop short of it.
+    return k + 1 == nodes_ ? hi_[f] : lo_[f] + step_[f] * static_cast<double>(k);
+}
+
+void PnlBounds::option_bounds(const double* shocks_row, double& lower, double& upper) const {
+    if (shocks_row == nullptr) {
+        throw std::invalid_argument("shocks_row must not be null");
+    }
+    lower = -value_today_ - slack_;
+    upper = -value_today_ + slack_;
+    for (std::size_t f = 0; f < factors_.size(); ++f) {
+        const double x = shocks_row[factors_[f]];
+        if (!(x >= lo_[f] && x <= hi_[f])) {
+            lower = -std::numeric_limits<double>::infinity();
+            upper = std::numeric_limits<double>::infinity();
+            return;
+        }
+        const double cell = step_[f] > 0.0 ? std::floor((x - lo_[f]) / step_[f]) : 0.0;
+        const std::size_t k = static_cast<std::size_t>(std::clamp(cell, 0.0, static_cast<double>(nodes_ - 2)));
+        const std::size_t i = f * nodes_ + k;
+        const double x0 = node(f, k);
+        const double x1 = node(f, k + 1);
+        const double w = x1 > x0 ? (x - x0) / (x1 - x0) : 0.0;
+
+        const double convex_chord = convex_[i] + w * (convex_[i + 1] - convex_[i]);
+        const double convex_tangent = std::max(convex_[i] + convex_slope_[i] * (x - x0),
+                                               convex_[i + 1] - convex_slope_[i + 1] * (x1 - x));
+        const double concave_chord = concave_[i] + w * (concave_[i + 1] - concave_[i]);
+        const double concave_tangent = std::min(concave_[i] + concave_slope_[i] * (x - x0),
+                                                concave_[i + 1] - concave_slope_[i + 1] * (x1 - x));
+        lower += convex_tangent + concave_chord;
+        upper += convex_chord + concave_tangent;
+    }
+}
+
+std::vector<std::size_t> tail_candidates(std::span<const double> lower, std::span<const double> upper, double q) {
+    if (lower.size() != upper.size()) {
+        throw std::invalid_argument("tail_candidates requires bounds of equal length");
+    }
+    std::vector<std::size_t> candidates;
+    const std::size_t n = lower.size();
+    if (n == 0) {
+        return candidates;
+    }
+    const std::size_t k = static_cast<std::size_t>(std::floor(std::clamp(q, 0.0, 1.0) * static_cast<double>(n - 1)));
+    std::vector<double> sorted(upper.begin(), upper.end());
+    std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(k), sorted.end());
+    const double threshold = sorted[k];
+
+    for (std::size_t t = 0; t < n; ++t) {
+        // Negated so that NaN bounds keep the scenario.
+        if (!(lower[t] > threshold)) {
+            candidates.push_back(t);
+        }
+    }
+    return candidates;
+}
+
+} // namespace risk
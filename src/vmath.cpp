@@ -0,0 +1,104 @@
+#include <risk/vmath.hpp>
+
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+
+namespace risk {
+
+namespace vmath {
+
+namespace {
+
+std::atomic<MathMode> g_mode{MathMode::Exact};
+
+void check_sizes(std::span<const double> x, std::span<double> out) {
+    if (x.size() != out.size()) {
+        throw std::invalid_argument("vmath output span must match input size");
+    }
+}
+
+} // namespace
+
+void set_math_mode(MathMode mode) {
+    g_mode.store(mode, std::memory_order_relaxed);
+}
+
+MathMode math_mode() {
+    return g_mode.load(std::memory_order_relaxed);
+}
+
+void exp(std::span<const double> x, std::span<double> out) {
+    check_sizes(x, out);
+    const std::size_t n = x.size();
+    if (math_mode() == MathMode::Fast) {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = fast_exp(x[i]);
+        }
+        return;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = std::exp(x[i]);
+    }
+}
+
+void expm1(std::span<const double> x, std::span<double> out) {
+    check_sizes(x, out);
+    const std::size_t n = x.size();
+    if (math_mode() == MathMode::Fast) {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = fast_expm1(x[i]);
+        }
+        return;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = std::expm1(x[i]);
+    }
+}
+
+void log(std::span<const double> x, std::span<double> out) {
+    check_sizes(x, out);
+    const std::size_t n = x.size();
+    if (math_mode() == MathMode::Fast) {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = fast_log(x[i]);
+        }
+        return;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = std::log(x[i]);
+    }
+}
+
+void normal_cdf(std::span<const double> x, std::span<double> out) {
+    check_sizes(x, out);
+    const std::size_t n = x.size();
+    if (math_mode() == MathMode::Fast) {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = fast_normal_cdf(x[i]);
+        }
+        return;
+    }
+    // Same expression as bs::normal_cdf, so exact mode reproduces the scalar pricer.
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = 0.5 * std::erfc(-x[i] / std::sqrt(2.0));
+    }
+}
+
+void normal_pdf(std::span<const double> x, std::span<double> out) {
+    check_sizes(x, out);
+    const std::size_t n = x.size();
+    if (math_mode() == MathMode::Fast) {
+        for (std::size_t i = 0; i < n; ++i) {
+            out[i] = fast_normal_pdf(x[i]);
+        }
+        return;
+    }
+    for (std::size_t i = 0; i < n; ++i) {
+        out[i] = detail::kInvSqrt2Pi * std::exp(-0.5 * x[i] * x[i]);
+    }
+}
+
+} // namespace vmath
+
+} // namespace risk
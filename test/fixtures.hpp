@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <risk/bs.hpp>
+#include <risk/instrument.hpp>
+
+// Instruments and shock matrices shared by the revaluation tests.
+namespace fixtures {
+
+struct OptionTerms {
+    double rate = 0.03;
+    double vol = 0.3;
+    double tau = 0.75;
+};
+
+// An option line priced at its Black-Scholes value today.
+inline risk::Instrument make_option(bool is_call,
+                                    std::uint32_t underlying,
+                                    double spot,
+                                    double strike,
+                                    double qty,
+                                    const OptionTerms& terms = {}) {
+    risk::Instrument option{};
+    option.id = underlying;
+    option.type = risk::InstrumentType::Option;
+    option.is_call = is_call;
+    option.qty = qty;
+    option.current_price = risk::bs::price(is_call, spot, strike, terms.rate, terms.vol, terms.tau);
+    option.underlying_price = spot;
+    option.underlying_index = underlying;
+    option.strike = strike;
+    option.time_to_maturity = terms.tau;
+    option.implied_vol = terms.vol;
+    option.rate = terms.rate;
+    return option;
+}
+
+inline risk::Instrument make_equity(std::uint32_t id, double price, double qty) {
+    risk::Instrument equity{};
+    equity.id = id;
+    equity.type = risk::InstrumentType::Equity;
+    equity.qty = qty;
+    equity.current_price = price;
+    equity.underlying_price = price;
+    equity.underlying_index = id;
+    return equity;
+}
+
+// Deterministic rows × cols shocks in [-amplitude, amplitude], uncorrelated
+// enough across rows and columns to spread a tail over many scenarios.
+inline std::vector<double> make_shocks(std::size_t rows, std::size_t cols, double amplitude) {
+    std::vector<double> shocks(rows * cols, 0.0);
+    for (std::size_t t = 0; t < rows; ++t) {
+        for (std::size_t i = 0; i < cols; ++i) {
+            const double phase = 0.61 * static_cast<double>(t) + 2.3 * static_cast<double>(i);
+            shocks[t * cols + i] = amplitude * std::sin(phase) * std::cos(0.13 * phase);
+        }
+    }
+    return shocks;
+}
+
+} // namespace fixtures
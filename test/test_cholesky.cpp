@@ -0,0 +1,133 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+#include <risk/cholesky.hpp>
+#include <risk/linalg.hpp>
+
+namespace {
+
+// B B^T for an n × r matrix B: positive semi-definite with rank min(n, r).
+risk::linalg::Matrix gram(std::size_t n, std::size_t r) {
+    risk::linalg::Matrix b(n, r);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t k = 0; k < r; ++k) {
+            std::uint64_t x = (i + 1) * 0x9E3779B97F4A7C15ULL ^ (k + 1) * 0xC2B2AE3D27D4EB4FULL;
+            x ^= x >> 29U;
+            x *= 0xBF58476D1CE4E5B9ULL;
+            x ^= x >> 32U;
+            b(i, k) = static_cast<double>(x >> 11U) * 0x1p-53 - 0.5;
+        }
+    }
+    risk::linalg::Matrix a(n, n);
+    risk::linalg::gemm(b, b.transposed(), a);
+    return a;
+}
+
+void require_reconstructs(const risk::linalg::Matrix& a, const risk::linalg::Matrix& factor) {
+    risk::linalg::Matrix product(a.rows(), a.cols());
+    risk::linalg::gemm(factor, factor.transposed(), product);
+    double worst = 0.0;
+    for (std::size_t i = 0; i < a.rows(); ++i) {
+        for (std::size_t j = 0; j < a.cols(); ++j) {
+            worst = std::max(worst, std::abs(product(i, j) - a(i, j)));
+        }
+    }
+    REQUIRE(worst < 1e-10);
+}
+
+} // namespace
+
+TEST_CASE("blocked cholesky factors across panel edges independently of threads") {
+    const std::size_t n = 150; // three panels, the last one ragged
+    const risk::linalg::Matrix a = gram(n, n + 10);
+
+    const risk::linalg::Matrix l = risk::linalg::cholesky(a);
+    for (std::size_t i = 0; i < n; ++i) {
+        REQUIRE(l(i, i) > 0.0);
+        for (std::size_t j = i + 1; j < n; ++j) {
+            REQUIRE(l(i, j) == 0.0);
+        }
+    }
+    require_reconstructs(a, l);
+
+    const risk::linalg::Matrix threaded = risk::linalg::cholesky(a, 3);
+    REQUIRE(std::equal(threaded.values().begin(), threaded.values().end(), l.values().begin()));
+
+    risk::linalg::Matrix indefinite = a;
+    indefinite(100, 100) = -1.0;
+    REQUIRE_THROWS_AS(risk::linalg::cholesky(indefinite), std::invalid_argument);
+    REQUIRE_THROWS_AS(risk::linalg::cholesky(gram(n, 40)), std::invalid_argument);
+    REQUIRE_THROWS_AS(risk::linalg::cholesky(risk::linalg::Matrix(2, 3)), std::invalid_argument);
+}
+
+TEST_CASE("pivoted_cholesky finds the rank of a semi-definite matrix") {
+    const std::size_t n = 130;
+    const risk::linalg::Matrix a = gram(n, 70);
+
+    const risk::linalg::PivotedCholesky result = risk::linalg::pivoted_cholesky(a, -1.0, 2);
+    REQUIRE(result.rank == 70);
+    REQUIRE(result.factor.rows() == n);
+    REQUIRE(result.factor.cols() == 70);
+    REQUIRE(result.condition >= 1.0);
+    require_reconstructs(a, result.factor);
+
+    // Full rank: same factor as cholesky up to the row order of the pivots.
+    const risk::linalg::Matrix full = gram(n, n + 10);
+    const risk::linalg::PivotedCholesky pivoted = risk::linalg::pivoted_cholesky(full);
+    REQUIRE(pivoted.rank == n);
+    require_reconstructs(full, pivoted.factor);
+
+    const risk::linalg::PivotedCholesky zero = risk::linalg::pivoted_cholesky(risk::linalg::Matrix(4, 4));
+    REQUIRE(zero.rank == 0);
+    REQUIRE(zero.factor.cols() == 0);
+
+    // [[1, 2], [2, 1]] has eigenvalue -1.
+    risk::linalg::Matrix indefinite(2, 2);
+    indefinite(0, 0) = 1.0;
+    indefinite(1, 1) = 1.0;
+    indefinite(1, 0) = 2.0;
+    REQUIRE_THROWS_AS(risk::linalg::pivoted_cholesky(indefinite), std::invalid_argument);
+}
+
+TEST_CASE("cholesky_update and cholesky_downdate match refactorization") {
+    const std::size_t n = 70;
+    risk::linalg::Matrix a = gram(n, 90);
+    risk::linalg::Matrix l = risk::linalg::cholesky(a);
+
+    std::vector<double> x(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        x[i] = std::sin(0.7 * static_cast<double>(i)) * 0.8;
+    }
+    risk::linalg::cholesky_update(l, x);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            a(i, j) += x[i] * x[j];
+        }
+    }
+    require_reconstructs(a, l);
+    for (std::size_t i = 0; i < n; ++i) {
+        REQUIRE(std::all_of(l.row(i).begin() + static_cast<std::ptrdiff_t>(i) + 1, l.row(i).end(), [](double v) {
+            return v == 0.0;
+        }));
+    }
+
+    REQUIRE(risk::linalg::cholesky_downdate(l, x));
+    require_reconstructs(gram(n, 90), l);
+
+    // Removing more than the matrix holds fails and leaves the factor alone.
+    const risk::linalg::Matrix before = l;
+    std::vector<double> large(n, 0.0);
+    large[5] = 2.0 * std::sqrt(a(5, 5));
+    REQUIRE_FALSE(risk::linalg::cholesky_downdate(l, large));
+    REQUIRE(std::equal(before.values().begin(), before.values().end(), l.values().begin()));
+
+    REQUIRE_THROWS_AS(risk::linalg::cholesky_update(l, std::vector<double>(n - 1)), std::invalid_argument);
+    REQUIRE_THROWS_AS(risk::linalg::cholesky_update(l = risk::linalg::Matrix(3, 3), std::vector<double>(3)),
+                      std::invalid_argument);
+}
@@ -0,0 +1,152 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <risk/factor_cache.hpp>
+
+namespace {
+
+// A fresh directory per test, removed on scope exit.
+struct ScratchDirectory {
+    explicit ScratchDirectory(const std::string& name)
+        : path(std::filesystem::temp_directory_path() /
+               (name + "_" + std::to_string(::getpid()))) {
+        std::filesystem::remove_all(path);
+    }
+    ~ScratchDirectory() {
+        std::error_code ec;
+        std::filesystem::remove_all(path, ec);
+    }
+
+    std::filesystem::path path;
+};
+
+} // namespace
+
+TEST_CASE("CacheKeyBuilder keys depend on every input and its order") {
+    const std::vector<double> values{1.0, 2.0, 3.0};
+    const risk::CacheKey key = risk::CacheKeyBuilder().add("moments").add(std::uint64_t{3}).add(values).key();
+    REQUIRE(key == risk::CacheKeyBuilder().add("moments").add(std::uint64_t{3}).add(values).key());
+    REQUIRE(key.hex().size() == 32);
+
+    std::vector<double> nudged = values;
+    nudged[2] = std::nextafter(3.0, 4.0);
+    REQUIRE_FALSE(key == risk::CacheKeyBuilder().add("moments").add(std::uint64_t{3}).add(nudged).key());
+    REQUIRE_FALSE(key == risk::CacheKeyBuilder().add("moment").add(std::uint64_t{3}).add(values).key());
+    REQUIRE_FALSE(key == risk::CacheKeyBuilder().add(std::uint64_t{3}).add("moments").add(values).key());
+    REQUIRE_FALSE(risk::CacheKeyBuilder().add(1.0).add(2.0).key() ==
+                  risk::CacheKeyBuilder().add(2.0).add(1.0).key());
+}
+
+TEST_CASE("FactorCache round-trips arrays and rejects damaged entries") {
+    const ScratchDirectory scratch("risk_factor_cache_test");
+    const risk::FactorCache cache(scratch.path.string());
+    const risk::CacheKey key = risk::CacheKeyBuilder().add("round-trip").key();
+    REQUIRE_FALSE(cache.load(key).has_value());
+
+    std::vector<double> matrix(5 * 3);
+    for (std::size_t i = 0; i < matrix.size(); ++i) {
+        matrix[i] = 0.25 * static_cast<double>(i) - 1.0;
+    }
+    const std::vector<double> row{3.5, -0.0, 1e-300};
+    const risk::CacheArray arrays[] = {{5, 3, matrix}, {1, 0, {}}, {1, 3, row}};
+    REQUIRE(cache.store(key, arrays));
+
+    {
+        const std::optional<risk::CacheEntry> entry = cache.load(key);
+        REQUIRE(entry.has_value());
+        REQUIRE(entry->size() == 3);
+        REQUIRE(entry->array(0).rows == 5);
+        REQUIRE(entry->array(0).cols == 3);
+        REQUIRE(std::equal(matrix.begin(), matrix.end(), entry->array(0).values.begin(), entry->array(0).values.end()));
+        REQUIRE(entry->array(1).values.empty());
+        REQUIRE(std::equal(row.begin(), row.end(), entry->array(2).values.begin(), entry->array(2).values.end()));
+        REQUIRE(reinterpret_cast<std::uintptr_t>(entry->array(2).values.data()) % 64 == 0);
+    }
+
+    // Another key never reads this entry, even if its file is put in place.
+    const risk::CacheKey other = risk::CacheKeyBuilder().add("other").key();
+    const std::filesystem::path file = scratch.path / (key.hex() + ".rfc");
+    std::filesystem::copy_file(file, scratch.path / (other.hex() + ".rfc"));
+    REQUIRE_FALSE(cache.load(other).has_value());
+
+    // A flipped payload bit passes the header check but fails the full one; a
+    // flipped shape bit fails both.
+    const auto size = std::filesystem::file_size(file);
+    const auto flip = [&](std::uintmax_t at) {
+        std::fstream stream(file, std::ios::in | std::ios::out | std::ios::binary);
+        stream.seekg(static_cast<std::streamoff>(at));
+        char byte = 0;
+        stream.read(&byte, 1);
+        byte = static_cast<char>(byte ^ 0x10);
+        stream.seekp(static_cast<std::streamoff>(at));
+        stream.write(&byte, 1);
+    };
+    REQUIRE(cache.load(key, risk::CacheCheck::Full).has_value());
+    flip(size - 8);
+    REQUIRE(cache.load(key).has_value());
+    REQUIRE_FALSE(cache.load(key, risk::CacheCheck::Full).has_value());
+    REQUIRE(cache.store(key, arrays));
+    flip(64 + 8);
+    REQUIRE_FALSE(cache.load(key).has_value());
+
+    // A truncated file fails the size check; storing again repairs it.
+    REQUIRE(cache.store(key, arrays));
+    std::filesystem::resize_file(file, size - 64);
+    REQUIRE_FALSE(cache.load(key).has_value());
+    REQUIRE(cache.store(key, arrays));
+    REQUIRE(cache.load(key).has_value());
+
+    const risk::CacheArray mismatched[] = {{2, 2, row}};
+    REQUIRE_FALSE(cache.store(key, mismatched));
+    REQUIRE(cache.load(key).has_value());
+}
+
+TEST_CASE("FactorCache evicts least recently used entries beyond its size limit") {
+    const ScratchDirectory scratch("risk_factor_cache_evict_test");
+    const std::vector<double> values(120, 1.5); // about 1 KiB per entry
+    const risk::CacheArray arrays[] = {{120, 1, values}};
+    const auto key = [](std::uint64_t i) { return risk::CacheKeyBuilder().add("evict").add(i).key(); };
+    const auto file = [&](std::uint64_t i) { return scratch.path / (key(i).hex() + ".rfc"); };
+
+    const risk::FactorCache unlimited(scratch.path.string());
+    REQUIRE(unlimited.store(key(0), arrays));
+    const std::uintmax_t entry_bytes = std::filesystem::file_size(file(0));
+    for (std::uint64_t i = 1; i < 4; ++i) {
+        REQUIRE(unlimited.store(key(i), arrays));
+    }
+
+    // Spread the entries over the past so their order does not rest on clock
+    // resolution: 0 is oldest, 3 newest. Loading 0 makes it the most recent.
+    const auto now = std::filesystem::file_time_type::clock::now();
+    for (std::uint64_t i = 0; i < 4; ++i) {
+        std::filesystem::last_write_time(file(i), now - std::chrono::hours(10 - i));
+    }
+    REQUIRE(unlimited.load(key(0)).has_value());
+
+    // Storing a fifth entry under a three-entry limit drops the two least
+    // recently used, 1 and 2, and never the entry just stored.
+    const risk::FactorCache limited(scratch.path.string(), 3 * entry_bytes);
+    REQUIRE(limited.max_bytes() == 3 * entry_bytes);
+    REQUIRE(limited.store(key(4), arrays));
+    REQUIRE(limited.load(key(0)).has_value());
+    REQUIRE_FALSE(std::filesystem::exists(file(1)));
+    REQUIRE_FALSE(std::filesystem::exists(file(2)));
+    REQUIRE(limited.load(key(3)).has_value());
+    REQUIRE(limited.load(key(4)).has_value());
+
+    // An entry larger than the limit is still kept.
+    const risk::FactorCache tiny(scratch.path.string(), 1);
+    REQUIRE(tiny.store(key(5), arrays));
+    REQUIRE(tiny.load(key(5)).has_value());
+    REQUIRE_FALSE(std::filesystem::exists(file(0)));
+}
@@ -0,0 +1,74 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <stdexcept>
+
+#include <risk/factor_model.hpp>
+#include <risk/linalg.hpp>
+
+using Catch::Approx;
+
+namespace {
+
+// Two market factors plus name-specific noise: Sigma = F F^T + D.
+risk::linalg::Matrix two_factor_covariance(std::size_t n) {
+    risk::linalg::Matrix f(n, 2);
+    for (std::size_t i = 0; i < n; ++i) {
+        f(i, 0) = 0.015 + 0.001 * static_cast<double>(i % 5);
+        f(i, 1) = (i % 2 == 0 ? 0.008 : -0.006);
+    }
+    risk::linalg::Matrix cov(n, n);
+    risk::linalg::gemm(f, f.transposed(), cov);
+    for (std::size_t i = 0; i < n; ++i) {
+        cov(i, i) += 1e-5 * static_cast<double>(1 + i % 3);
+    }
+    return cov;
+}
+
+} // namespace
+
+TEST_CASE("pca_factor_model keeps every variance and most of the covariance") {
+    const std::size_t n = 30;
+    const risk::linalg::Matrix cov = two_factor_covariance(n);
+
+    const risk::FactorModel model = risk::pca_factor_model(cov, 2);
+    REQUIRE(model.loadings_t.rows() == 2);
+    REQUIRE(model.loadings_t.cols() == n);
+    REQUIRE(model.explained_variance > 0.9);
+    REQUIRE(model.explained_variance < 1.0);
+
+    double worst_off_diagonal = 0.0;
+    double largest = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            double implied = model.loadings_t(0, i) * model.loadings_t(0, j) + model.loadings_t(1, i) * model.loadings_t(1, j);
+            if (i == j) {
+                implied += model.specific[i] * model.specific[i];
+                REQUIRE(implied == Approx(cov(i, i)).epsilon(1e-12));
+            } else {
+                worst_off_diagonal = std::max(worst_off_diagonal, std::abs(implied - cov(i, j)));
+            }
+            largest = std::max(largest, std::abs(cov(i, j)));
+        }
+    }
+    REQUIRE(worst_off_diagonal < 0.05 * largest);
+
+    // All components reproduce the matrix with no idiosyncratic term left.
+    const risk::FactorModel full = risk::pca_factor_model(cov, n);
+    REQUIRE(full.explained_variance == Approx(1.0).epsilon(1e-12));
+    risk::linalg::Matrix rebuilt(n, n);
+    risk::linalg::gemm(full.loadings_t.transposed(), full.loadings_t, rebuilt);
+    for (std::size_t i = 0; i < n; ++i) {
+        REQUIRE(full.specific[i] < 1e-6);
+        for (std::size_t j = 0; j < n; ++j) {
+            REQUIRE(rebuilt(i, j) == Approx(cov(i, j)).margin(1e-14));
+        }
+    }
+
+    REQUIRE_THROWS_AS(risk::pca_factor_model(cov, 0), std::invalid_argument);
+    REQUIRE_THROWS_AS(risk::pca_factor_model(cov, n + 1), std::invalid_argument);
+    REQUIRE_THROWS_AS(risk::pca_factor_model(risk::linalg::Matrix(3, 2), 1), std::invalid_argument);
+}
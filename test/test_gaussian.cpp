@@ -0,0 +1,103 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+#include <stdexcept>
+#include <vector>
+
+#include <risk/gaussian.hpp>
+#include <risk/rng.hpp>
+
+using Catch::Approx;
+
+namespace {
+
+double reference_cdf(double x) {
+    return 0.5 * std::erfc(-x / std::sqrt(2.0));
+}
+
+double reference_pdf(double x) {
+    return std::exp(-0.5 * x * x) / std::sqrt(2.0 * std::numbers::pi);
+}
+
+} // namespace
+
+TEST_CASE("normal_quantile inverts the normal CDF to near machine precision") {
+    double worst = 0.0;
+    // Lower half on a log scale down to the smallest uniform to_unit_open emits.
+    for (double lp = std::log(0x1p-53); lp <= std::log(0.5); lp += 0.0013) {
+        const double p = std::exp(lp);
+        const double x = risk::rng::normal_quantile(p);
+        // One Newton step from x lands on the true quantile to second order.
+        const double correction = (reference_cdf(x) - p) / reference_pdf(x);
+        worst = std::max(worst, std::abs(correction) / std::max(1.0, std::abs(x)));
+    }
+    REQUIRE(worst <= 1e-14);
+
+    for (double p = 0.001; p < 0.5; p += 0.00037) {
+        REQUIRE(risk::rng::normal_quantile(1.0 - p) == Approx(-risk::rng::normal_quantile(p)).epsilon(1e-12));
+    }
+    REQUIRE(risk::rng::normal_quantile(0.5) == 0.0);
+    REQUIRE(risk::rng::normal_quantile(0.975) == Approx(1.959963984540054).epsilon(1e-15));
+}
+
+TEST_CASE("bulk normal_quantile matches the scalar function bit for bit") {
+    std::vector<double> u(1000);
+    risk::rng::uniform_open(11, 3, u);
+    u[0] = 0x1p-53;
+    u[1] = 1.0 - 0x1p-53;
+    u[2] = 0.5 + risk::rng::detail::kCentralLimit;
+
+    std::vector<double> z(u.size());
+    risk::rng::normal_quantile(u, z);
+    for (std::size_t i = 0; i < u.size(); ++i) {
+        REQUIRE(z[i] == risk::rng::normal_quantile(u[i]));
+    }
+
+    // In-place evaluation is allowed.
+    risk::rng::normal_quantile(u, u);
+    REQUIRE(u == z);
+
+    std::vector<double> short_out(z.size() - 1);
+    REQUIRE_THROWS_AS(risk::rng::normal_quantile(z, short_out), std::invalid_argument);
+}
+
+TEST_CASE("path normals have standard normal moments and pass a KS test") {
+    constexpr std::size_t paths = 10000;
+    constexpr std::size_t dim = 10;
+    std::vector<double> z;
+    z.reserve(paths * dim);
+    std::vector<double> row(dim);
+    for (std::size_t p = 0; p < paths; ++p) {
+        risk::rng::path_normals(2024, p, row);
+        z.insert(z.end(), row.begin(), row.end());
+    }
+
+    const double n = static_cast<double>(z.size());
+    double m1 = 0.0;
+    double m2 = 0.0;
+    double m3 = 0.0;
+    double m4 = 0.0;
+    for (double v : z) {
+        m1 += v;
+        m2 += v * v;
+        m3 += v * v * v;
+        m4 += v * v * v * v;
+    }
+    // Sampling standard errors at n = 1e5: 0.003, 0.0045, 0.008, 0.025.
+    REQUIRE(m1 / n == Approx(0.0).margin(0.015));
+    REQUIRE(m2 / n == Approx(1.0).margin(0.02));
+    REQUIRE(m3 / n == Approx(0.0).margin(0.04));
+    REQUIRE(m4 / n == Approx(3.0).margin(0.12));
+
+    std::sort(z.begin(), z.end());
+    double ks = 0.0;
+    for (std::size_t i = 0; i < z.size(); ++i) {
+        const double cdf = reference_cdf(z[i]);
+        ks = std::max(ks, std::max(cdf - static_cast<double>(i) / n, static_cast<double>(i + 1) / n - cdf));
+    }
+    // 1% critical value of the Kolmogorov-Smirnov statistic is 1.628 / sqrt(n).
+    REQUIRE(ks < 1.628 / std::sqrt(n));
+}
@@ -72,3 +72,48 @@ TEST_CASE("compute_greeks matches analytic Black-Scholes outputs") {
     REQUIRE(totals.theta == Approx(per_position[0].theta + per_position[1].theta).margin(kTolerance));
     REQUIRE(totals.rho == Approx(per_position[0].rho + per_position[1].rho).margin(kTolerance));
 }
+
+TEST_CASE("compute_greeks preserves position order for interleaved books") {
+    std::vector<risk::Instrument> book;
+    for (std::uint32_t i = 0; i < 6; ++i) {
+        risk::Instrument inst{};
+        inst.id = i;
+        inst.qty = static_cast<double>(i) - 2.5;
+        inst.current_price = 40.0 + static_cast<double>(i);
+        inst.underlying_price = 100.0;
+        inst.underlying_index = 0;
+        if (i % 2 == 0) {
+            inst.type = risk::InstrumentType::Option;
+            inst.is_call = (i % 4 == 0);
+            inst.strike = 90.0 + 5.0 * static_cast<double>(i);
+            inst.time_to_maturity = 0.25 * static_cast<double>(i + 1);
+            inst.implied_vol = 0.2;
+            inst.rate = 0.01;
+        }
+        book.push_back(inst);
+    }
+    const auto soa = risk::to_struct_of_arrays(book);
+
+    std::vector<risk::bs::BSGreeks> per_contract;
+    std::vector<risk::bs::BSGreeks> per_position;
+    risk::GreeksSummary totals;
+    risk::compute_greeks(soa, per_contract, per_position, totals);
+
+    double delta_sum = 0.0;
+    for (std::size_t i = 0; i < book.size(); ++i) {
+        const auto& inst = book[i];
+        risk::bs::BSGreeks expected{};
+        if (inst.type == risk::InstrumentType::Option) {
+            expected = inst.is_call ? risk::bs::call(100.0, inst.strike, 0.01, 0.2, inst.time_to_maturity)
+                                    : risk::bs::put(100.0, inst.strike, 0.01, 0.2, inst.time_to_maturity);
+        } else {
+            expected.price = inst.current_price;
+            expected.delta = 1.0;
+        }
+        REQUIRE(per_contract[i].price == expected.price);
+        REQUIRE(per_contract[i].delta == expected.delta);
+        REQUIRE(per_position[i].delta == expected.delta * inst.qty);
+        delta_sum += expected.delta * inst.qty;
+    }
+    REQUIRE(totals.delta == delta_sum);
+}
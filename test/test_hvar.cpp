@@ -5,6 +5,7 @@
 
 using Catch::Approx;
 
+#include <risk/bs.hpp>
 #include <risk/hvar.hpp>
 #include <risk/instrument.hpp>
 #include <risk/instrument_soa.hpp>
@@ -62,3 +63,49 @@ TEST_CASE("compute_hvar validates shock dimensions") {
                                          0.95),
                       std::invalid_argument);
 }
+
+TEST_CASE("hvarday reprices options at the shocked underlying") {
+    risk::set_universe({"SPY", "QQQ", "XOM", "TSLA", "AAPL", "WMT"});
+    const std::size_t universe_size = risk::universe_size();
+
+    risk::Instrument equity{};
+    equity.id = 0;
+    equity.type = risk::InstrumentType::Equity;
+    equity.qty = 100.0;
+    equity.current_price = 450.0;
+    equity.underlying_price = equity.current_price;
+    equity.underlying_index = 0;
+
+    risk::Instrument call{};
+    call.id = 1;
+    call.type = risk::InstrumentType::Option;
+    call.is_call = true;
+    call.qty = 10.0;
+    call.current_price = 15.0;
+    call.underlying_price = 101.0;
+    call.underlying_index = 1;
+    call.strike = 105.0;
+    call.time_to_maturity = 0.5;
+    call.implied_vol = 0.25;
+    call.rate = 0.02;
+
+    risk::Instrument put = call;
+    put.is_call = false;
+    put.qty = -4.0;
+    put.current_price = 6.0;
+    put.underlying_index = 2;
+    put.underlying_price = 90.0;
+
+    const auto soa = risk::to_struct_of_arrays({equity, call, put});
+
+    std::vector<double> shocks(universe_size, 0.0);
+    shocks[0] = -0.03;
+    shocks[1] = 0.04;
+    shocks[2] = -0.07;
+
+    const double expected = equity.qty * equity.current_price * shocks[0] +
+                            call.qty * (risk::bs::price(true, 101.0 * 1.04, 105.0, 0.02, 0.25, 0.5) - call.current_price) +
+                            put.qty * (risk::bs::price(false, 90.0 * 0.93, 105.0, 0.02, 0.25, 0.5) - put.current_price);
+
+    REQUIRE(risk::hvarday(soa, shocks.data()) == Approx(expected).epsilon(1e-12));
+}
@@ -3,6 +3,10 @@
 
 #include <risk/instrument.hpp>
 #include <risk/instrument_soa.hpp>
+#include <risk/partition.hpp>
+
+#include <stdexcept>
+#include <vector>
 
 using Catch::Approx;
 
@@ -48,3 +52,57 @@ TEST_CASE("to_struct_of_arrays preserves instrument fields") {
     REQUIRE(soa.time_to_maturity[1] == Approx(option.time_to_maturity));
     REQUIRE(soa.rate[1] == Approx(option.rate));
 }
+
+TEST_CASE("partition_by_kind splits stably and maps rows back to positions") {
+    std::vector<risk::Instrument> book;
+    for (std::uint32_t i = 0; i < 7; ++i) {
+        risk::Instrument inst{};
+        inst.id = i;
+        inst.qty = static_cast<double>(i + 1);
+        inst.current_price = 10.0;
+        if (i % 3 != 0) {
+            inst.type = risk::InstrumentType::Option;
+            inst.is_call = (i % 3 == 1);
+            inst.strike = 10.0 + static_cast<double>(i);
+        }
+        book.push_back(inst);
+    }
+    const auto soa = risk::to_struct_of_arrays(book);
+    const auto parts = risk::partition_by_kind(soa);
+
+    REQUIRE(parts.equity_index == std::vector<std::size_t>{0, 3, 6});
+    REQUIRE(parts.call_index == std::vector<std::size_t>{1, 4});
+    REQUIRE(parts.put_index == std::vector<std::size_t>{2, 5});
+
+    REQUIRE(parts.equities.size() == 3);
+    REQUIRE(parts.calls.size() == 2);
+    REQUIRE(parts.puts.size() == 2);
+    for (std::size_t k = 0; k < parts.puts.size(); ++k) {
+        const std::size_t i = parts.put_index[k];
+        REQUIRE(parts.puts.id[k] == soa.id[i]);
+        REQUIRE(parts.puts.qty[k] == soa.qty[i]);
+        REQUIRE(parts.puts.strike[k] == soa.strike[i]);
+        REQUIRE(parts.puts.is_call[k] == 0);
+    }
+}
+
+TEST_CASE("referenced_factors lists the shocked factors and remaps the book onto them") {
+    risk::Instrument equity{};
+    equity.id = 40;
+    equity.type = risk::InstrumentType::Equity;
+    risk::Instrument call{};
+    call.id = 7;
+    call.type = risk::InstrumentType::Option;
+    call.underlying_index = 12;
+    risk::Instrument other{};
+    other.id = 12;
+    other.type = risk::InstrumentType::Equity;
+    const auto soa = risk::to_struct_of_arrays({equity, call, other});
+
+    const risk::FactorSubset subset = risk::referenced_factors(soa, 50);
+    REQUIRE(subset.factors == std::vector<std::uint32_t>{12, 40});
+    REQUIRE(subset.soa.id == std::vector<std::uint32_t>{1, 7, 0});
+    REQUIRE(subset.soa.underlying_index == std::vector<std::uint32_t>{0, 0, 0});
+
+    REQUIRE_THROWS_AS(risk::referenced_factors(soa, 40), std::out_of_range);
+}
@@ -0,0 +1,222 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <cstdint>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include <risk/eigen_stub.hpp>
+#include <risk/linalg.hpp>
+
+using Catch::Approx;
+
+TEST_CASE("gemv matches a naive matrix-vector product on ragged shapes") {
+    for (std::size_t rows : {1U, 3U, 4U, 9U}) {
+        for (std::size_t cols : {1U, 7U, 8U, 21U}) {
+            std::vector<double> a(rows * cols);
+            std::vector<double> x(cols);
+            for (std::size_t i = 0; i < a.size(); ++i) {
+                a[i] = 0.5 - static_cast<double>((i * 37) % 11) / 10.0;
+            }
+            for (std::size_t j = 0; j < cols; ++j) {
+                x[j] = 1.0 + static_cast<double>(j) / 3.0;
+            }
+
+            std::vector<double> y(rows, -1.0);
+            risk::linalg::gemv(a, rows, cols, x, y);
+            for (std::size_t r = 0; r < rows; ++r) {
+                double expected = 0.0;
+                for (std::size_t j = 0; j < cols; ++j) {
+                    expected += a[r * cols + j] * x[j];
+                }
+                REQUIRE(y[r] == Approx(expected).margin(1e-12));
+                // Rows of gemv and a standalone dot use the same summation order.
+                REQUIRE(y[r] == risk::linalg::dot(std::span<const double>(a.data() + r * cols, cols), x));
+            }
+        }
+    }
+}
+
+TEST_CASE("gemm matches a naive product across block and tile edges") {
+    const std::size_t m = 7;
+    const std::size_t k = 300;
+    const std::size_t n = 37;
+    risk::linalg::Matrix a(m, k);
+    risk::linalg::Matrix b(k, n);
+    for (std::size_t i = 0; i < m; ++i) {
+        for (std::size_t p = 0; p < k; ++p) {
+            a(i, p) = 0.5 - static_cast<double>((i * 31 + p * 7) % 13) / 12.0;
+        }
+    }
+    for (std::size_t p = 0; p < k; ++p) {
+        for (std::size_t j = 0; j < n; ++j) {
+            b(p, j) = static_cast<double>((p * 5 + j * 3) % 17) / 8.0 - 1.0;
+        }
+    }
+
+    risk::linalg::Matrix c(m, n);
+    for (std::size_t i = 0; i < m; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            c(i, j) = static_cast<double>(i) - static_cast<double>(j);
+        }
+    }
+    const risk::linalg::Matrix c0 = c;
+    risk::linalg::gemm(a, b, c);
+
+    for (std::size_t i = 0; i < m; ++i) {
+        for (std::size_t j = 0; j < n; ++j) {
+            double expected = c0(i, j);
+            for (std::size_t p = 0; p < k; ++p) {
+                expected += a(i, p) * b(p, j);
+            }
+            REQUIRE(c(i, j) == Approx(expected).margin(1e-11));
+        }
+    }
+
+    // A row computed on its own is bit-identical to the same row in a block.
+    for (std::size_t i = 0; i < m; ++i) {
+        std::vector<double> single(c0.row(i).begin(), c0.row(i).end());
+        risk::linalg::gemm(a.row(i), 1, k, b.values(), n, single);
+        for (std::size_t j = 0; j < n; ++j) {
+            REQUIRE(single[j] == c(i, j));
+        }
+    }
+
+    const risk::linalg::Matrix bt = b.transposed();
+    REQUIRE(bt.rows() == n);
+    REQUIRE(bt.cols() == k);
+    REQUIRE(bt(5, 123) == b(123, 5));
+}
+
+TEST_CASE("symmetric_eigen finds the leading eigenpairs, clustered ones included") {
+    // A = B B^T is symmetric positive semi-definite with rank 29 < n.
+    const std::size_t n = 45;
+    risk::linalg::Matrix b(n, 29);
+    for (std::size_t i = 0; i < n; ++i) {
+        for (std::size_t j = 0; j < 29; ++j) {
+            b(i, j) = 0.5 - static_cast<double>((i * 17 + j * 29 + i * j) % 23) / 22.0;
+        }
+    }
+    risk::linalg::Matrix a(n, n);
+    risk::linalg::gemm(b, b.transposed(), a);
+
+    const risk::linalg::SymmetricEigen all = risk::linalg::symmetric_eigen(a, n);
+    double trace = 0.0;
+    double sum = 0.0;
+    for (std::size_t i = 0; i < n; ++i) {
+        trace += a(i, i);
+        sum += all.values[i];
+        if (i > 0) {
+            REQUIRE(all.values[i] <= all.values[i - 1]);
+        }
+    }
+    REQUIRE(sum == Approx(trace).epsilon(1e-12));
+    REQUIRE(all.values[n - 1] == Approx(0.0).margin(1e-10 * all.values[0]));
+
+    const std::size_t count = 6;
+    const risk::linalg::SymmetricEigen top = risk::linalg::symmetric_eigen(a, count);
+    REQUIRE(top.vectors.rows() == count);
+    std::vector<double> av(n);
+    for (std::size_t j = 0; j < count; ++j) {
+        REQUIRE(top.values[j] == all.values[j]);
+        risk::linalg::gemv(a.values(), n, n, top.vectors.row(j), av);
+        for (std::size_t i = 0; i < n; ++i) {
+            REQUIRE(av[i] == Approx(top.values[j] * top.vectors(j, i)).margin(1e-12 * top.values[0]));
+        }
+    }
+
+    // 2 I plus a rank-one block: eigenvalue 2 repeats n - 1 times, and the
+    // vectors found for it must still be orthonormal.
+    risk::linalg::Matrix c(n, n);
+    for (std::size_t i = 0; i < n; ++i) {
+        c(i, i) = 2.0;
+        for (std::size_t j = 0; j < 3; ++j) {
+            c(i, j) += i < 3 ? 1.0 : 0.0;
+        }
+    }
+    const risk::linalg::SymmetricEigen clustered = risk::linalg::symmetric_eigen(c, 10);
+    REQUIRE(clustered.values[0] == Approx(5.0).epsilon(1e-14));
+    for (std::size_t j = 1; j < 10; ++j) {
+        REQUIRE(clustered.values[j] == Approx(2.0).epsilon(1e-14));
+    }
+    for (std::size_t j = 0; j < 10; ++j) {
+        for (std::size_t t = 0; t <= j; ++t) {
+            const double product = risk::linalg::dot(clustered.vectors.row(j), clustered.vectors.row(t));
+            REQUIRE(product == Approx(t == j ? 1.0 : 0.0).margin(1e-12));
+        }
+    }
+
+    REQUIRE_THROWS_AS(risk::linalg::symmetric_eigen(b, 1), std::invalid_argument);
+    REQUIRE_THROWS_AS(risk::linalg::symmetric_eigen(a, n + 1), std::invalid_argument);
+}
+
+TEST_CASE("Eigen stand-in types share aligned row-major storage with linalg") {
+    risk::linalg::Matrix m(3, 5);
+    m(2, 4) = 7.0;
+    const double* storage = m.values().data();
+    Eigen::MatrixXd adopted(std::move(m));
+    REQUIRE(adopted.values().data() == storage);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(storage) % 64 == 0);
+    REQUIRE(adopted(2, 4) == 7.0);
+    REQUIRE(adopted.row(2)[4] == 7.0);
+    REQUIRE(adopted.matrix().values().data() == storage);
+
+    adopted.row(1)[0] = -1.0;
+    REQUIRE(adopted.values()[5] == -1.0);
+    const risk::linalg::Matrix released = std::move(adopted).matrix();
+    REQUIRE(released.values().data() == storage);
+    REQUIRE(released(1, 0) == -1.0);
+
+    const std::vector<double> values{1.0, 2.0, 3.0};
+    const Eigen::VectorXd v(values);
+    REQUIRE(v.size() == 3);
+    REQUIRE(v(2) == 3.0);
+    REQUIRE(reinterpret_cast<std::uintptr_t>(v.data()) % 64 == 0);
+}
+
+TEST_CASE("Eigen stand-in maps and column views do not copy") {
+    std::vector<double> values{1.0, 2.0, 3.0, 4.0, 5.0, 6.0};
+    const Eigen::Map<const Eigen::VectorXd> v(values);
+    REQUIRE(v.data() == values.data());
+    REQUIRE(v.size() == 6);
+    REQUIRE(v(4) == 5.0);
+
+    // 2 × 3, row-major.
+    const Eigen::Map<Eigen::MatrixXd> m(values, 2, 3);
+    REQUIRE(m(1, 0) == 4.0);
+    REQUIRE(m.row(1).data() == values.data() + 3);
+    const Eigen::StridedVector<double> column = m.col(2);
+    REQUIRE(column.size() == 2);
+    REQUIRE(column.stride() == 3);
+    REQUIRE(column.data() == values.data() + 2);
+    REQUIRE(column(0) == 3.0);
+    REQUIRE(column(1) == 6.0);
+    column(1) = -6.0;
+    REQUIRE(values[5] == -6.0);
+    REQUIRE(Eigen::Map<const Eigen::MatrixXd>(values, 3, 2)(2, 1) == -6.0);
+
+    Eigen::MatrixXd owned = Eigen::MatrixXd::Zero(4, 3);
+    owned(3, 1) = 9.0;
+    owned.col(1)(0) = 2.0;
+    const Eigen::MatrixXd& view = owned;
+    const Eigen::StridedVector<const double> second = view.col(1);
+    REQUIRE(second.data() == owned.values().data() + 1);
+    REQUIRE(second(0) == 2.0);
+    REQUIRE(second(3) == 9.0);
+    REQUIRE(second.size() == 4);
+}
+
+TEST_CASE("linalg kernels reject mismatched shapes") {
+    const std::vector<double> a(6, 1.0);
+    const std::vector<double> x(3, 1.0);
+    std::vector<double> y(3, 0.0);
+    REQUIRE_THROWS_AS(risk::linalg::gemv(a, 2, 3, x, y), std::invalid_argument);
+    REQUIRE_THROWS_AS(risk::linalg::dot(a, x), std::invalid_argument);
+
+    const risk::linalg::Matrix a23(2, 3);
+    const risk::linalg::Matrix b23(2, 3);
+    risk::linalg::Matrix c22(2, 2);
+    REQUIRE_THROWS_AS(risk::linalg::gemm(a23, b23, c22), std::invalid_argument);
+    REQUIRE_THROWS_AS(risk::linalg::gemm(a, 2, 3, x, 2, y), std::invalid_argument);
+}
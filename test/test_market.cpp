@@ -0,0 +1,126 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <risk/market.hpp>
+#include <risk/universe.hpp>
+
+namespace {
+
+// Writes contents to a per-process temporary file, removed on scope exit.
+struct ScratchCsv {
+    explicit ScratchCsv(const std::string& contents)
+        : path(std::filesystem::temp_directory_path() / ("risk_market_test_" + std::to_string(::getpid()) + ".csv")) {
+        std::ofstream(path, std::ios::binary) << contents;
+    }
+    ~ScratchCsv() {
+        std::error_code ec;
+        std::filesystem::remove(path, ec);
+    }
+
+    std::filesystem::path path;
+};
+
+bool load(const std::string& contents, std::size_t threads = 1) {
+    const ScratchCsv csv(contents);
+    std::vector<std::string> dates;
+    std::vector<double> prices;
+    std::size_t T = 0;
+    std::size_t N = 0;
+    return risk::load_closes_csv(csv.path.string(), dates, prices, T, N, threads);
+}
+
+} // namespace
+
+TEST_CASE("load_closes_csv parses padded, CRLF and blank-line input") {
+    const ScratchCsv csv("date, SPY ,QQQ\r\n"
+                         "2024-01-02, 470.5,+401.25\r\n"
+                         "\r\n"
+                         "  \n"
+                         " 2024-01-03 ,4.7e2,402\n"
+                         "2024-01-04,471.125,399.5");
+    std::vector<std::string> dates{"stale"};
+    std::vector<double> prices{1.0};
+    std::size_t T = 0;
+    std::size_t N = 0;
+    REQUIRE(risk::load_closes_csv(csv.path.string(), dates, prices, T, N));
+    REQUIRE(T == 3);
+    REQUIRE(N == 2);
+    REQUIRE(risk::universe_symbols() == std::vector<std::string>{"SPY", "QQQ"});
+    REQUIRE(dates == std::vector<std::string>{"2024-01-02", "2024-01-03", "2024-01-04"});
+    REQUIRE(prices == std::vector<double>{470.5, 401.25, 470.0, 402.0, 471.125, 399.5});
+}
+
+TEST_CASE("load_closes_csv gives the same result for any chunking and thread count") {
+    // Several parser chunks' worth of rows; %.17g round-trips every close.
+    const std::size_t rows = 4000;
+    const std::size_t tickers = 12;
+    std::string contents = "date";
+    for (std::size_t i = 0; i < tickers; ++i) {
+        contents += ",T" + std::to_string(i);
+    }
+    contents += "\n";
+    std::vector<double> expected;
+    char buffer[32];
+    for (std::size_t t = 0; t < rows; ++t) {
+        contents += "d" + std::to_string(t);
+        for (std::size_t i = 0; i < tickers; ++i) {
+            const double close = 100.0 + static_cast<double>((t * 7919 + i * 104729) % 10007) / 3.0;
+            std::snprintf(buffer, sizeof(buffer), ",%.17g", close);
+            contents += buffer;
+            expected.push_back(close);
+        }
+        contents += t % 97 == 0 ? "\n\n" : "\n";
+    }
+    REQUIRE(contents.size() > 4 * 65536);
+
+    const ScratchCsv csv(contents);
+    for (std::size_t threads : {1U, 3U, 8U}) {
+        std::vector<std::string> dates;
+        std::vector<double> prices;
+        std::size_t T = 0;
+        std::size_t N = 0;
+        REQUIRE(risk::load_closes_csv(csv.path.string(), dates, prices, T, N, threads));
+        REQUIRE(T == rows);
+        REQUIRE(N == tickers);
+        REQUIRE(dates.back() == "d3999");
+        REQUIRE(prices == expected);
+    }
+
+    // A bad close in the last chunk is still found.
+    std::string broken = contents;
+    broken.replace(broken.rfind(',') + 1, 3, "abc");
+    REQUIRE_FALSE(load(broken, 4));
+}
+
+TEST_CASE("load_closes_csv rejects malformed files") {
+    const std::string header = "date,SPY,QQQ\n";
+    REQUIRE(load(header + "2024-01-02,470,401\n"));
+
+    REQUIRE_FALSE(load(""));
+    REQUIRE_FALSE(load("SPY,QQQ\n2024-01-02,470,401\n"));
+    REQUIRE_FALSE(load("date\n2024-01-02\n"));
+    REQUIRE_FALSE(load("date,SPY,,QQQ\n2024-01-02,470,1,401\n"));
+    REQUIRE_FALSE(load(header));
+    REQUIRE_FALSE(load(header + "2024-01-02,470\n"));
+    REQUIRE_FALSE(load(header + "2024-01-02,470,401,\n"));
+    REQUIRE_FALSE(load(header + "2024-01-02,470,\n"));
+    REQUIRE_FALSE(load(header + "2024-01-02,470,abc\n"));
+    REQUIRE_FALSE(load(header + "2024-01-02,470,401x\n"));
+    REQUIRE_FALSE(load(header + "2024-01-02,470,0\n"));
+    REQUIRE_FALSE(load(header + "2024-01-02,-470,401\n"));
+    REQUIRE_FALSE(load(header + "2024-01-02,470,inf\n"));
+    REQUIRE_FALSE(load(header + "2024-01-02,470,1 2\n"));
+
+    std::vector<std::string> dates;
+    std::vector<double> prices;
+    std::size_t T = 0;
+    std::size_t N = 0;
+    REQUIRE_FALSE(risk::load_closes_csv("/nonexistent/closes.csv", dates, prices, T, N));
+}
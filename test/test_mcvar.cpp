@@ -2,14 +2,25 @@
 #include <catch2/catch_approx.hpp>
 
 #include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
 
 #include <risk/eigen_stub.hpp>
 
+#include <risk/factor_cache.hpp>
+#include <risk/gaussian.hpp>
 #include <risk/instrument.hpp>
 #include <risk/instrument_soa.hpp>
 #include <risk/mcvar.hpp>
 #include <risk/universe.hpp>
 
+#include "fixtures.hpp"
+
 using Catch::Approx;
 
 namespace {
@@ -67,3 +78,532 @@ TEST_CASE("compute_mcvar matches deterministic drift-only scenario") {
     REQUIRE(metrics.var == Approx(expected_loss).margin(1e-6));
     REQUIRE(metrics.cvar == Approx(expected_loss).margin(1e-6));
 }
+
+TEST_CASE("compute_mcvar grid revaluation agrees with full repricing") {
+    risk::set_universe({"SPY", "QQQ"});
+    risk::Instrument call{};
+    call.id = 0;
+    call.type = risk::InstrumentType::Option;
+    call.is_call = true;
+    call.qty = 10.0;
+    call.current_price = 6.0;
+    call.underlying_price = 100.0;
+    call.underlying_index = 0;
+    call.strike = 100.0;
+    call.time_to_maturity = 0.5;
+    call.implied_vol = 0.2;
+    call.rate = 0.01;
+    const auto soa = risk::to_struct_of_arrays({call});
+
+    const Eigen::VectorXd mu = Eigen::VectorXd::Zero(2);
+    Eigen::MatrixXd cov = Eigen::MatrixXd::Zero(2, 2);
+    cov(0, 0) = 4e-4;
+    cov(1, 1) = 1e-4;
+
+    const auto full = risk::compute_mcvar(soa, mu, cov, 1.0, 0.99, 4000, 11ULL);
+
+    risk::RevaluationOptions options;
+    options.mode = risk::RevaluationMode::Grid;
+    options.grid_nodes = 128;
+    risk::RevaluationStats stats;
+    const auto grid = risk::compute_mcvar(soa, mu, cov, 1.0, 0.99, 4000, 11ULL, options, &stats);
+
+    REQUIRE(grid.var == Approx(full.var).margin(1e-6));
+    REQUIRE(grid.cvar == Approx(full.cvar).margin(1e-6));
+    REQUIRE(stats.grid_nodes == 128);
+    REQUIRE(stats.checked_rows > 0);
+    REQUIRE(stats.max_abs_error < 1e-6);
+}
+
+TEST_CASE("compute_mcvar is bit-identical for every thread count") {
+    risk::set_universe({"SPY", "QQQ", "XOM"});
+    risk::Instrument put{};
+    put.id = 1;
+    put.type = risk::InstrumentType::Option;
+    put.is_call = false;
+    put.qty = 25.0;
+    put.current_price = 3.0;
+    put.underlying_price = 80.0;
+    put.underlying_index = 1;
+    put.strike = 78.0;
+    put.time_to_maturity = 0.3;
+    put.implied_vol = 0.25;
+    put.rate = 0.02;
+    risk::Instrument equity{};
+    equity.id = 0;
+    equity.type = risk::InstrumentType::Equity;
+    equity.qty = -40.0;
+    equity.current_price = 50.0;
+    equity.underlying_price = 50.0;
+    equity.underlying_index = 0;
+    const auto soa = risk::to_struct_of_arrays({put, equity});
+
+    Eigen::VectorXd mu = Eigen::VectorXd::Zero(3);
+    mu(0) = 0.0005;
+    Eigen::MatrixXd cov = Eigen::MatrixXd::Zero(3, 3);
+    cov(0, 0) = 4e-4;
+    cov(1, 1) = 3e-4;
+    cov(2, 2) = 1e-4;
+    cov(0, 1) = cov(1, 0) = 1.5e-4;
+
+    risk::RevaluationOptions options;
+    options.block_rows = 100;
+    const auto serial = risk::compute_mcvar(soa, mu, cov, 1.0, 0.99, 3000, 5ULL, options);
+    REQUIRE(serial.var > 0.0);
+    for (const std::size_t threads : {2, 7}) {
+        options.threads = threads;
+        const auto parallel = risk::compute_mcvar(soa, mu, cov, 1.0, 0.99, 3000, 5ULL, options);
+        REQUIRE(parallel.var == serial.var);
+        REQUIRE(parallel.cvar == serial.cvar);
+    }
+
+    options.prune_tail = true;
+    risk::RevaluationStats stats;
+    const auto pruned = risk::compute_mcvar(soa, mu, cov, 1.0, 0.99, 3000, 5ULL, options, &stats);
+    REQUIRE(pruned.var == serial.var);
+    REQUIRE(pruned.cvar == serial.cvar);
+    REQUIRE(stats.pruned_rows > 0);
+}
+
+namespace {
+
+// RMS error of the MC VaR of 100 shares over `seeds` seeds against the exact
+// lognormal quantile; mean_stderr receives the average reported VaR stderr.
+double equity_var_rmse(const risk::MonteCarloOptions& sampling, int paths, int seeds, double* mean_stderr = nullptr) {
+    const auto soa = make_single_equity(50.0, 100.0);
+    const std::size_t n = risk::universe_size();
+    const Eigen::VectorXd mu = Eigen::VectorXd::Zero(n);
+    Eigen::MatrixXd cov = Eigen::MatrixXd::Zero(n, n);
+    for (std::size_t i = 0; i < n; ++i) {
+        cov(i, i) = 4e-4;
+    }
+    cov(0, 1) = cov(1, 0) = 2e-4;
+    const double exact = -5000.0 * std::expm1(0.02 * risk::rng::normal_quantile(0.01));
+
+    double sum_sq = 0.0;
+    double sum_stderr = 0.0;
+    for (int s = 0; s < seeds; ++s) {
+        const auto metrics = risk::compute_mcvar(soa, mu, cov, 1.0, 0.99, paths, 1000ULL + s, {}, nullptr, sampling);
+        sum_sq += (metrics.var - exact) * (metrics.var - exact);
+        sum_stderr += metrics.var_stderr;
+    }
+    if (mean_stderr != nullptr) {
+        *mean_stderr = sum_stderr / seeds;
+    }
+    return std::sqrt(sum_sq / seeds);
+}
+
+risk::MonteCarloOptions with_sampler(risk::MonteCarloSampler sampler) {
+    risk::MonteCarloOptions sampling;
+    sampling.sampler = sampler;
+    return sampling;
+}
+
+} // namespace
+
+TEST_CASE("compute_mcvar Sobol sampling beats pseudo-random paths at equal count") {
+    const double pseudo = equity_var_rmse(with_sampler(risk::MonteCarloSampler::Pseudo), 4096, 8);
+    const double sobol = equity_var_rmse(with_sampler(risk::MonteCarloSampler::Sobol), 4096, 8);
+    REQUIRE(sobol < pseudo / 3.0);
+}
+
+TEST_CASE("compute_mcvar importance sampling cuts the VaR error and reports it") {
+    double plain_stderr = 0.0;
+    const double plain = equity_var_rmse({}, 16384, 8, &plain_stderr);
+
+    risk::MonteCarloOptions tilted;
+    tilted.importance_sampling = true;
+    double tilted_stderr = 0.0;
+    const double tilted_rmse = equity_var_rmse(tilted, 16384, 8, &tilted_stderr);
+
+    REQUIRE(tilted_rmse < plain / 3.0);
+    // Batch-means standard errors track the actual error across seeds.
+    REQUIRE(plain_stderr > 0.5 * plain);
+    REQUIRE(plain_stderr < 2.0 * plain);
+    REQUIRE(tilted_stderr > 0.5 * tilted_rmse);
+    REQUIRE(tilted_stderr < 2.0 * tilted_rmse);
+}
+
+TEST_CASE("compute_mcvar antithetic paths work with every revaluation mode") {
+    risk::set_universe({"SPY", "QQQ"});
+    risk::Instrument call{};
+    call.id = 0;
+    call.type = risk::InstrumentType::Option;
+    call.is_call = true;
+    call.qty = -10.0;
+    call.current_price = 6.0;
+    call.underlying_price = 100.0;
+    call.underlying_index = 0;
+    call.strike = 100.0;
+    call.time_to_maturity = 0.5;
+    call.implied_vol = 0.2;
+    call.rate = 0.01;
+    const auto soa = risk::to_struct_of_arrays({call});
+
+    const Eigen::VectorXd mu = Eigen::VectorXd::Zero(2);
+    Eigen::MatrixXd cov = Eigen::MatrixXd::Zero(2, 2);
+    cov(0, 0) = 4e-4;
+    cov(1, 1) = 1e-4;
+
+    risk::MonteCarloOptions sampling;
+    sampling.antithetic = true;
+    risk::RevaluationOptions options;
+    options.block_rows = 37; // odd, so pairs straddle blocks
+    const auto full = risk::compute_mcvar(soa, mu, cov, 1.0, 0.99, 2001, 3ULL, options, nullptr, sampling);
+    REQUIRE(full.var > 0.0);
+    REQUIRE(full.var_stderr > 0.0);
+
+    options.prune_tail = true;
+    const auto pruned = risk::compute_mcvar(soa, mu, cov, 1.0, 0.99, 2001, 3ULL, options, nullptr, sampling);
+    REQUIRE(pruned.var == full.var);
+    REQUIRE(pruned.cvar == full.cvar);
+
+    options.prune_tail = false;
+    options.mode = risk::RevaluationMode::Hybrid;
+    const auto hybrid = risk::compute_mcvar(soa, mu, cov, 1.0, 0.99, 2001, 3ULL, options, nullptr, sampling);
+    REQUIRE(hybrid.var == full.var);
+    REQUIRE(hybrid.cvar == full.cvar);
+
+    sampling.importance_sampling = true;
+    REQUIRE_THROWS_AS(risk::compute_mcvar(soa, mu, cov, 1.0, 0.99, 2001, 3ULL, options, nullptr, sampling),
+                      std::invalid_argument);
+}
+
+TEST_CASE("compute_mcvar PCA factor paths match full Cholesky paths on a factor-driven book") {
+    // Each variance is kept exactly, so a one-name book is priced correctly
+    // with a single component.
+    risk::MonteCarloOptions one_factor;
+    one_factor.pca_factors = 1;
+    const double full_rmse = equity_var_rmse({}, 4096, 8);
+    const double pca_rmse = equity_var_rmse(one_factor, 4096, 8);
+    REQUIRE(pca_rmse < 2.0 * full_rmse);
+
+    // Twelve names on two market factors plus small specific risk.
+    std::vector<std::string> names;
+    std::vector<risk::Instrument> book;
+    for (int i = 0; i < 12; ++i) {
+        names.push_back("N" + std::to_string(i));
+        risk::Instrument inst{};
+        inst.id = i;
+        inst.type = risk::InstrumentType::Equity;
+        inst.qty = 10.0 + i;
+        inst.current_price = 40.0 + 3.0 * i;
+        inst.underlying_price = inst.current_price;
+        inst.underlying_index = i;
+        book.push_back(inst);
+    }
+    risk::set_universe(names);
+    const auto soa = risk::to_struct_of_arrays(book);
+    const Eigen::VectorXd mu = Eigen::VectorXd::Zero(12);
+    Eigen::MatrixXd cov = Eigen::MatrixXd::Zero(12, 12);
+    for (int i = 0; i < 12; ++i) {
+        for (int j = 0; j < 12; ++j) {
+            const double market = 1.5e-4;
+            const double sector = (i % 2 == j % 2) ? 0.5e-4 : -0.2e-4;
+            cov(i, j) = market + sector + (i == j ? 0.2e-4 : 0.0);
+        }
+    }
+
+    const auto full = risk::compute_mcvar(soa, mu, cov, 1.0, 0.99, 32768, 3ULL);
+    risk::MonteCarloOptions sampling;
+    sampling.pca_factors = 2;
+    risk::MonteCarloModel model;
+    const auto pca = risk::compute_mcvar(soa, mu, cov, 1.0, 0.99, 32768, 3ULL, {}, nullptr, sampling, &model);
+    REQUIRE(model.pca_factors == 2);
+    REQUIRE(model.normals == 14);
+    REQUIRE(model.explained_variance > 0.9);
+    REQUIRE(pca.var == Approx(full.var).epsilon(0.03));
+    REQUIRE(pca.cvar == Approx(full.cvar).epsilon(0.03));
+
+    // Sobol points and importance sampling work on the factor normals too.
+    sampling.sampler = risk::MonteCarloSampler::Sobol;
+    sampling.importance_sampling = true;
+    const auto shifted = risk::compute_mcvar(soa, mu, cov, 1.0, 0.99, 32768, 3ULL, {}, nullptr, sampling);
+    REQUIRE(shifted.var == Approx(full.var).epsilon(0.03));
+
+    risk::MonteCarloModel cholesky;
+    (void)risk::compute_mcvar(soa, mu, cov, 1.0, 0.99, 64, 3ULL, {}, nullptr, {}, &cholesky);
+    REQUIRE(cholesky.pca_factors == 0);
+    REQUIRE(cholesky.normals == 12);
+    REQUIRE(cholesky.explained_variance == 1.0);
+
+    sampling.pca_factors = 13;
+    REQUIRE_THROWS_AS(risk::compute_mcvar(soa, mu, cov, 1.0, 0.99, 64, 3ULL, {}, nullptr, sampling),
+                      std::invalid_argument);
+}
+
+TEST_CASE("compute_mcvar simulates only the factors the portfolio references") {
+    // A call on name 150 and stock in name 30 of a 200-name universe give the
+    // same paths, bit for bit, as a two-name universe holding just those names.
+    std::vector<std::string> names;
+    for (int i = 0; i < 200; ++i) {
+        names.push_back("N" + std::to_string(i));
+    }
+    Eigen::VectorXd mu = Eigen::VectorXd::Zero(200);
+    Eigen::MatrixXd cov = Eigen::MatrixXd::Zero(200, 200);
+    for (int i = 0; i < 200; ++i) {
+        mu(i) = 1e-5 * (i % 7);
+        for (int j = 0; j < 200; ++j) {
+            cov(i, j) = (i == j ? 3e-4 : 0.0) + 1e-4 / (1.0 + std::abs(i - j));
+        }
+    }
+    risk::Instrument call{};
+    call.id = 0;
+    call.type = risk::InstrumentType::Option;
+    call.is_call = true;
+    call.qty = 10.0;
+    call.current_price = 6.0;
+    call.underlying_price = 100.0;
+    call.underlying_index = 150;
+    call.strike = 100.0;
+    call.time_to_maturity = 0.5;
+    call.implied_vol = 0.2;
+    call.rate = 0.01;
+    risk::Instrument stock{};
+    stock.id = 30;
+    stock.type = risk::InstrumentType::Equity;
+    stock.qty = -20.0;
+    stock.current_price = 45.0;
+    stock.underlying_price = 45.0;
+
+    risk::MonteCarloOptions sampling;
+    sampling.sampler = risk::MonteCarloSampler::Sobol;
+    risk::set_universe(names);
+    risk::MonteCarloModel model;
+    const auto wide = risk::compute_mcvar(risk::to_struct_of_arrays({call, stock}), mu, cov, 1.0, 0.99, 4096, 8ULL, {},
+                                          nullptr, sampling, &model);
+    REQUIRE(model.factors == 2);
+    REQUIRE(model.normals == 2);
+
+    risk::set_universe({"N30", "N150"});
+    Eigen::VectorXd sub_mu = Eigen::VectorXd::Zero(2);
+    Eigen::MatrixXd sub_cov = Eigen::MatrixXd::Zero(2, 2);
+    const int picked[2] = {30, 150};
+    for (int r = 0; r < 2; ++r) {
+        sub_mu(r) = mu(picked[r]);
+        for (int c = 0; c < 2; ++c) {
+            sub_cov(r, c) = cov(picked[r], picked[c]);
+        }
+    }
+    call.underlying_index = 1;
+    stock.id = 0;
+    const auto narrow = risk::compute_mcvar(risk::to_struct_of_arrays({call, stock}), sub_mu, sub_cov, 1.0, 0.99, 4096,
+                                            8ULL, {}, nullptr, sampling);
+    REQUIRE(wide.var == narrow.var);
+    REQUIRE(wide.cvar == narrow.cvar);
+}
+
+TEST_CASE("compute_mcvar draws only rank-many normals for a singular covariance") {
+    // Two perfectly correlated names: the book is one position of 100 * 50.
+    risk::set_universe({"A", "B"});
+    risk::Instrument first{};
+    first.id = 0;
+    first.type = risk::InstrumentType::Equity;
+    first.qty = 60.0;
+    first.current_price = 50.0;
+    first.underlying_price = 50.0;
+    risk::Instrument second = first;
+    second.id = 1;
+    second.qty = 40.0;
+    const auto soa = risk::to_struct_of_arrays({first, second});
+    const Eigen::VectorXd mu = Eigen::VectorXd::Zero(2);
+    Eigen::MatrixXd cov = Eigen::MatrixXd::Zero(2, 2);
+    cov(0, 0) = cov(1, 1) = cov(0, 1) = cov(1, 0) = 4e-4;
+
+    risk::MonteCarloModel model;
+    const auto metrics = risk::compute_mcvar(soa, mu, cov, 1.0, 0.99, 16384, 4ULL, {}, nullptr,
+                                             with_sampler(risk::MonteCarloSampler::Sobol), &model);
+    REQUIRE(model.rank == 1);
+    REQUIRE(model.normals == 1);
+    const double exact = -5000.0 * std::expm1(0.02 * risk::rng::normal_quantile(0.01));
+    REQUIRE(metrics.var == Approx(exact).epsilon(0.01));
+
+    cov(0, 1) = cov(1, 0) = 8e-4; // correlation 2
+    REQUIRE_THROWS_AS(risk::compute_mcvar(soa, mu, cov, 1.0, 0.99, 64, 4ULL), std::invalid_argument);
+}
+
+TEST_CASE("compute_mcvar reuses cached path factors bit for bit") {
+    const std::filesystem::path directory =
+        std::filesystem::temp_directory_path() / ("risk_mcvar_cache_test_" + std::to_string(::getpid()));
+    std::filesystem::remove_all(directory);
+    const risk::FactorCache cache(directory.string());
+
+    const auto soa = make_single_equity(100.0, 3.0);
+    Eigen::VectorXd mu = Eigen::VectorXd::Zero(6);
+    Eigen::MatrixXd cov = Eigen::MatrixXd::Zero(6, 6);
+    for (int i = 0; i < 6; ++i) {
+        for (int j = 0; j < 6; ++j) {
+            cov(i, j) = (i == j ? 3e-4 : 1e-4);
+        }
+    }
+
+    for (std::size_t pca_factors : {0U, 1U}) {
+        risk::MonteCarloOptions sampling;
+        sampling.pca_factors = pca_factors;
+        const auto uncached = risk::compute_mcvar(soa, mu, cov, 1.0, 0.99, 4096, 5ULL, {}, nullptr, sampling);
+
+        sampling.factor_cache = &cache;
+        risk::MonteCarloModel first;
+        risk::MonteCarloModel second;
+        const auto stored = risk::compute_mcvar(soa, mu, cov, 1.0, 0.99, 4096, 5ULL, {}, nullptr, sampling, &first);
+        const auto loaded = risk::compute_mcvar(soa, mu, cov, 1.0, 0.99, 4096, 5ULL, {}, nullptr, sampling, &second);
+        REQUIRE_FALSE(first.cached);
+        REQUIRE(second.cached);
+        REQUIRE(second.normals == first.normals);
+        REQUIRE(second.rank == first.rank);
+        REQUIRE(second.explained_variance == first.explained_variance);
+        REQUIRE(stored.var == uncached.var);
+        REQUIRE(loaded.var == uncached.var);
+        REQUIRE(loaded.cvar == uncached.cvar);
+
+        // A longer horizon scales the covariance and so misses the cache.
+        risk::MonteCarloModel other;
+        (void)risk::compute_mcvar(soa, mu, cov, 2.0, 0.99, 64, 5ULL, {}, nullptr, sampling, &other);
+        REQUIRE_FALSE(other.cached);
+    }
+    std::filesystem::remove_all(directory);
+}
+
+TEST_CASE("compute_mcvar_adaptive stops on its tolerance, path cap or time budget") {
+    const auto soa = make_single_equity(50.0, 100.0);
+    const std::size_t n = risk::universe_size();
+    const Eigen::VectorXd mu = Eigen::VectorXd::Zero(n);
+    Eigen::MatrixXd cov = Eigen::MatrixXd::Zero(n, n);
+    for (std::size_t i = 0; i < n; ++i) {
+        cov(i, i) = 4e-4;
+    }
+
+    risk::AdaptiveMonteCarloOptions adaptive;
+    adaptive.tolerance = 0.02;
+    adaptive.initial_paths = 2000;
+    adaptive.max_paths = 1 << 20;
+    const auto converged = risk::compute_mcvar_adaptive(soa, mu, cov, 1.0, 0.99, 9ULL, adaptive);
+    REQUIRE(converged.converged);
+    REQUIRE(converged.paths > 2000);
+    REQUIRE(converged.paths < (1U << 20));
+    REQUIRE(converged.var_half_width <= 0.02 * converged.metrics.var);
+    REQUIRE(converged.cvar_half_width <= 0.02 * converged.metrics.cvar);
+    REQUIRE(converged.elapsed_seconds > 0.0);
+
+    // The paths are compute_mcvar's, and earlier rounds are reused, not redrawn.
+    const auto fixed = risk::compute_mcvar(soa, mu, cov, 1.0, 0.99, static_cast<int>(converged.paths), 9ULL);
+    REQUIRE(converged.metrics.var == fixed.var);
+    REQUIRE(converged.metrics.cvar == fixed.cvar);
+    REQUIRE(converged.metrics.var_stderr == fixed.var_stderr);
+
+    adaptive.tolerance = 1e-6;
+    adaptive.max_paths = 8000;
+    const auto capped = risk::compute_mcvar_adaptive(soa, mu, cov, 1.0, 0.99, 9ULL, adaptive);
+    REQUIRE_FALSE(capped.converged);
+    REQUIRE(capped.paths == 8000);
+
+    adaptive.time_budget_seconds = 1e-9;
+    const auto timed = risk::compute_mcvar_adaptive(soa, mu, cov, 1.0, 0.99, 9ULL, adaptive);
+    REQUIRE_FALSE(timed.converged);
+    REQUIRE(timed.paths == 2000);
+
+    risk::RevaluationOptions pruned;
+    pruned.prune_tail = true;
+    REQUIRE_THROWS_AS(risk::compute_mcvar_adaptive(soa, mu, cov, 1.0, 0.99, 9ULL, adaptive, pruned),
+                      std::invalid_argument);
+    adaptive.initial_paths = 0;
+    REQUIRE_THROWS_AS(risk::compute_mcvar_adaptive(soa, mu, cov, 1.0, 0.99, 9ULL, adaptive), std::invalid_argument);
+
+    // Too few paths for batch-means errors would give a zero-width interval
+    // and a false convergence.
+    adaptive.initial_paths = 30;
+    adaptive.max_paths = 30;
+    REQUIRE_THROWS_AS(risk::compute_mcvar_adaptive(soa, mu, cov, 1.0, 0.99, 9ULL, adaptive), std::invalid_argument);
+    adaptive.initial_paths = 40;
+    adaptive.max_paths = 40;
+    const auto smallest = risk::compute_mcvar_adaptive(soa, mu, cov, 1.0, 0.99, 9ULL, adaptive);
+    REQUIRE(smallest.var_half_width > 0.0);
+}
+
+TEST_CASE("compute_mcvar_adaptive converges at once on a book with no P&L") {
+    const auto soa = make_single_equity(100.0);
+    const std::size_t n = risk::universe_size();
+    const Eigen::VectorXd mu = Eigen::VectorXd::Zero(n);
+    const Eigen::MatrixXd cov = Eigen::MatrixXd::Zero(n, n);
+
+    // VaR, ES and both standard errors are zero; their ratio must not be 0 / 0.
+    risk::AdaptiveMonteCarloOptions adaptive;
+    adaptive.tolerance = 0.01;
+    adaptive.initial_paths = 64;
+    adaptive.max_paths = 4096;
+    const auto result = risk::compute_mcvar_adaptive(soa, mu, cov, 1.0, 0.99, 5ULL, adaptive);
+    REQUIRE(result.converged);
+    REQUIRE(result.paths == 64);
+    REQUIRE(result.metrics.var == 0.0);
+    REQUIRE(result.var_half_width == 0.0);
+}
+
+// Not run by default: `risk_tests "[benchmark]"` prints VaR error against path
+// count for both samplers.
+TEST_CASE("compute_mcvar VaR convergence by sampler", "[.][benchmark]") {
+    std::printf("%8s %14s %14s\n", "paths", "pseudo rmse", "sobol rmse");
+    for (int paths = 1024; paths <= 262144; paths *= 4) {
+        std::printf("%8d %14.6f %14.6f\n",
+                    paths,
+                    equity_var_rmse(with_sampler(risk::MonteCarloSampler::Pseudo), paths, 16),
+                    equity_var_rmse(with_sampler(risk::MonteCarloSampler::Sobol), paths, 16));
+    }
+}
+
+namespace {
+
+// MC VaR of a 20-factor option book: one call or put per factor, daily vols
+// of 1-3% and 0.3 pairwise correlation.
+double option_book_var(risk::MonteCarloSampler sampler, int paths, std::uint64_t seed) {
+    constexpr std::size_t kFactors = 20;
+    std::vector<std::string> names;
+    std::vector<risk::Instrument> book;
+    for (std::size_t i = 0; i < kFactors; ++i) {
+        names.push_back("F" + std::to_string(i));
+        book.push_back(fixtures::make_option(i % 3 != 0,
+                                             static_cast<std::uint32_t>(i),
+                                             100.0,
+                                             90.0 + static_cast<double>(i),
+                                             i % 2 == 0 ? 10.0 : -6.0));
+    }
+    risk::set_universe(names);
+    const auto soa = risk::to_struct_of_arrays(book);
+    const Eigen::VectorXd mu = Eigen::VectorXd::Zero(kFactors);
+    Eigen::MatrixXd cov = Eigen::MatrixXd::Zero(kFactors, kFactors);
+    for (std::size_t i = 0; i < kFactors; ++i) {
+        for (std::size_t j = 0; j < kFactors; ++j) {
+            const double vol_i = 0.01 + 0.001 * static_cast<double>(i);
+            const double vol_j = 0.01 + 0.001 * static_cast<double>(j);
+            cov(i, j) = (i == j ? 1.0 : 0.3) * vol_i * vol_j;
+        }
+    }
+    return risk::compute_mcvar(soa, mu, cov, 1.0, 0.99, paths, seed, {}, nullptr, with_sampler(sampler)).var;
+}
+
+double option_book_var_rmse(risk::MonteCarloSampler sampler, int paths, int seeds, double reference) {
+    double sum_sq = 0.0;
+    for (int s = 0; s < seeds; ++s) {
+        const double error = option_book_var(sampler, paths, 2000ULL + s) - reference;
+        sum_sq += error * error;
+    }
+    return std::sqrt(sum_sq / seeds);
+}
+
+} // namespace
+
+// Not run by default: the same table for the 20-factor option book, against
+// the mean of 16 Sobol runs of 2^20 paths.
+TEST_CASE("compute_mcvar VaR convergence by sampler on 20 factors", "[.][benchmark]") {
+    double reference = 0.0;
+    for (int s = 0; s < 16; ++s) {
+        reference += option_book_var(risk::MonteCarloSampler::Sobol, 1 << 20, 9000ULL + s) / 16.0;
+    }
+    std::printf("reference VaR %.6f\n", reference);
+    std::printf("%8s %14s %14s\n", "paths", "pseudo rmse", "sobol rmse");
+    for (int paths = 1024; paths <= 65536; paths *= 4) {
+        std::printf("%8d %14.6f %14.6f\n",
+                    paths,
+                    option_book_var_rmse(risk::MonteCarloSampler::Pseudo, paths, 32, reference),
+                    option_book_var_rmse(risk::MonteCarloSampler::Sobol, paths, 32, reference));
+    }
+}
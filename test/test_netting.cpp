@@ -0,0 +1,97 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <vector>
+
+#include <risk/bs.hpp>
+#include <risk/hvar.hpp>
+#include <risk/instrument.hpp>
+#include <risk/instrument_soa.hpp>
+#include <risk/netting.hpp>
+#include <risk/prepared_portfolio.hpp>
+#include <risk/universe.hpp>
+
+#include "fixtures.hpp"
+
+using Catch::Approx;
+
+namespace {
+
+constexpr fixtures::OptionTerms kTerms{0.02, 0.25, 0.5};
+
+} // namespace
+
+TEST_CASE("net_contracts merges identical contracts and keeps the line mapping") {
+    auto fallback = fixtures::make_option(true, 0, 100.0, 100.0, 1.0, kTerms);
+    fallback.underlying_price = 0.0; // resolves to current_price, so it is a distinct contract
+
+    const std::vector<risk::Instrument> lines{
+        fixtures::make_option(true, 0, 100.0, 100.0, 5.0, kTerms),
+        fixtures::make_equity(1, 40.0, 10.0),
+        fixtures::make_option(false, 0, 100.0, 100.0, 2.0, kTerms),
+        fixtures::make_option(true, 0, 100.0, 100.0, -3.0, kTerms),
+        fixtures::make_option(true, 0, 100.0, 105.0, 1.0, kTerms),
+        fixtures::make_equity(1, 40.0, -4.0),
+        fixtures::make_option(true, 0, 100.0, 100.0, 4.0, kTerms),
+        fallback,
+    };
+    const auto soa = risk::to_struct_of_arrays(lines);
+    const risk::NettedContracts netted = risk::net_contracts(soa);
+
+    REQUIRE(netted.contracts.size() == 5);
+    REQUIRE(netted.line_to_contract == std::vector<std::size_t>{0, 1, 2, 0, 3, 1, 0, 4});
+    REQUIRE(netted.contracts.qty[0] == Approx(6.0));
+    REQUIRE(netted.contracts.qty[1] == Approx(6.0));
+    REQUIRE(netted.contracts.qty[2] == Approx(2.0));
+    REQUIRE(netted.contracts.underlying_price[4] == Approx(fallback.current_price));
+
+    REQUIRE(netted.value_today.size() == netted.contracts.size());
+    for (std::size_t c = 0; c < netted.contracts.size(); ++c) {
+        double expected = 0.0;
+        for (std::size_t i = 0; i < lines.size(); ++i) {
+            if (netted.line_to_contract[i] == c) {
+                expected += lines[i].qty * lines[i].current_price;
+            }
+        }
+        REQUIRE(netted.value_today[c] == Approx(expected));
+    }
+}
+
+TEST_CASE("PreparedPortfolio prices duplicated option lines once with the same P&L") {
+    std::vector<risk::Instrument> lines;
+    for (int account = 0; account < 12; ++account) {
+        lines.push_back(fixtures::make_option(true, 0, 100.0, 95.0, 1.0 + account, kTerms));
+        lines.push_back(fixtures::make_option(false, 1, 100.0, 110.0, -0.5 * account, kTerms));
+    }
+    const auto soa = risk::to_struct_of_arrays(lines);
+
+    const risk::PreparedPortfolio prepared(soa, 2);
+    REQUIRE(prepared.option_count() == lines.size());
+    REQUIRE(prepared.contract_count() == 2);
+
+    const std::vector<double> row{0.04, -0.07};
+    double expected = 0.0;
+    for (const auto& line : lines) {
+        const double shocked = 100.0 * (1.0 + row[line.underlying_index]);
+        expected += line.qty * (risk::bs::price(line.is_call, shocked, line.strike, 0.02, 0.25, 0.5) -
+                                line.current_price);
+    }
+    REQUIRE(prepared.revalue(row.data()) == Approx(expected).epsilon(1e-12));
+}
+
+TEST_CASE("compute_hvar reports the netted contract count") {
+    risk::set_universe({"SPY", "QQQ"});
+    std::vector<risk::Instrument> lines;
+    for (int account = 0; account < 5; ++account) {
+        lines.push_back(fixtures::make_option(true, 0, 100.0, 95.0, 1.0 + account, kTerms));
+        lines.push_back(fixtures::make_option(true, 0, 100.0, 105.0, 2.0, kTerms));
+    }
+    lines.push_back(fixtures::make_equity(1, 50.0, 10.0));
+    const auto soa = risk::to_struct_of_arrays(lines);
+
+    const std::vector<double> shocks{0.01, -0.02, -0.03, 0.01, 0.02, 0.00};
+    risk::RevaluationStats stats;
+    risk::compute_hvar(soa, shocks, 3, 2, 0.95, {}, &stats);
+    REQUIRE(stats.option_lines == 10);
+    REQUIRE(stats.contracts == 2);
+}
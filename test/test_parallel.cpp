@@ -0,0 +1,103 @@
+#include <catch2/catch_test_macros.hpp>
+
+#include <atomic>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <risk/bs.hpp>
+#include <risk/hvar.hpp>
+#include <risk/instrument.hpp>
+#include <risk/instrument_soa.hpp>
+#include <risk/parallel.hpp>
+#include <risk/universe.hpp>
+
+TEST_CASE("parallel_for visits every index once and rethrows body exceptions") {
+    for (const std::size_t threads : {1, 3, 8}) {
+        std::vector<std::atomic<int>> visits(1000);
+        std::vector<std::size_t> block_begin(1000 / 64 + 1, 0);
+        risk::parallel_for(1000, 64, threads, [&](std::size_t block, std::size_t begin, std::size_t end) {
+            block_begin[block] = begin;
+            for (std::size_t i = begin; i < end; ++i) {
+                visits[i].fetch_add(1);
+            }
+        });
+        for (const auto& count : visits) {
+            REQUIRE(count.load() == 1);
+        }
+        for (std::size_t b = 0; b < block_begin.size(); ++b) {
+            REQUIRE(block_begin[b] == b * 64);
+        }
+    }
+
+    REQUIRE_THROWS_AS(risk::parallel_for(100, 10, 4,
+                                         [](std::size_t block, std::size_t, std::size_t) {
+                                             if (block == 7) {
+                                                 throw std::runtime_error("block failed");
+                                             }
+                                         }),
+                      std::runtime_error);
+    REQUIRE_THROWS_AS(risk::parallel_for(10, 0, 1, [](std::size_t, std::size_t, std::size_t) {}),
+                      std::invalid_argument);
+    REQUIRE(risk::resolve_thread_count(0) >= 1);
+    REQUIRE(risk::resolve_thread_count(5) == 5);
+}
+
+TEST_CASE("compute_hvar is bit-identical for every thread count") {
+    risk::set_universe({"SPY", "QQQ", "XOM"});
+    std::vector<risk::Instrument> lines;
+    for (int i = 0; i < 30; ++i) {
+        risk::Instrument option{};
+        option.id = static_cast<std::uint32_t>(i % 3);
+        option.type = risk::InstrumentType::Option;
+        option.is_call = i % 2 == 0;
+        option.qty = (i % 7) - 3.0;
+        option.underlying_price = 100.0;
+        option.underlying_index = option.id;
+        option.strike = 80.0 + 1.5 * i;
+        option.time_to_maturity = 0.1 + 0.03 * i;
+        option.implied_vol = 0.25;
+        option.rate = 0.02;
+        option.current_price = risk::bs::price(option.is_call, 100.0, option.strike, 0.02, 0.25, option.time_to_maturity);
+        lines.push_back(option);
+    }
+    risk::Instrument equity{};
+    equity.id = 1;
+    equity.type = risk::InstrumentType::Equity;
+    equity.qty = 25.0;
+    equity.current_price = 100.0;
+    equity.underlying_price = 100.0;
+    equity.underlying_index = 1;
+    lines.push_back(equity);
+    const auto soa = risk::to_struct_of_arrays(lines);
+
+    const std::size_t rows = 1001;
+    std::vector<double> shocks(rows * 3);
+    for (std::size_t k = 0; k < shocks.size(); ++k) {
+        shocks[k] = 0.07 * std::sin(0.91 * static_cast<double>(k)) * std::cos(0.017 * static_cast<double>(k));
+    }
+
+    for (const risk::RevaluationMode mode : {risk::RevaluationMode::Full,
+                                             risk::RevaluationMode::Grid,
+                                             risk::RevaluationMode::DeltaGamma,
+                                             risk::RevaluationMode::Hybrid}) {
+        for (const bool prune : {false, true}) {
+            risk::RevaluationOptions options;
+            options.mode = mode;
+            options.prune_tail = prune;
+            options.block_rows = 37;
+            risk::RevaluationStats serial_stats;
+            const auto serial = risk::compute_hvar(soa, shocks, rows, 3, 0.99, options, &serial_stats);
+            for (const std::size_t threads : {2, 5, 16}) {
+                options.threads = threads;
+                risk::RevaluationStats stats;
+                const auto parallel = risk::compute_hvar(soa, shocks, rows, 3, 0.99, options, &stats);
+                REQUIRE(parallel.var == serial.var);
+                REQUIRE(parallel.cvar == serial.cvar);
+                REQUIRE(stats.max_abs_error == serial_stats.max_abs_error);
+                REQUIRE(stats.rms_error == serial_stats.rms_error);
+                REQUIRE(stats.pruned_rows == serial_stats.pruned_rows);
+            }
+        }
+    }
+}
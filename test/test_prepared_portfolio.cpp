@@ -0,0 +1,148 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <risk/bs.hpp>
+#include <risk/instrument.hpp>
+#include <risk/instrument_soa.hpp>
+#include <risk/prepared_portfolio.hpp>
+#include <risk/vmath.hpp>
+
+#include "fixtures.hpp"
+
+using Catch::Approx;
+
+TEST_CASE("PreparedPortfolio revalues a mixed book like full Black-Scholes repricing") {
+    const risk::Instrument equity = fixtures::make_equity(2, 80.0, -30.0);
+
+    const risk::Instrument call = fixtures::make_option(true, 0, 100.0, 95.0, 7.0);
+    const risk::Instrument put = fixtures::make_option(false, 1, 50.0, 55.0, -3.0);
+    const auto soa = risk::to_struct_of_arrays({call, equity, put});
+
+    const risk::PreparedPortfolio prepared(soa, 3);
+    REQUIRE(prepared.factor_count() == 3);
+    REQUIRE(prepared.equity_count() == 1);
+    REQUIRE(prepared.option_count() == 2);
+
+    const std::vector<std::vector<double>> rows{
+        {0.0, 0.0, 0.0},
+        {0.05, -0.02, 0.01},
+        {-1.5, 0.3, -0.2}, // shocked spot below zero prices the call at zero
+    };
+    for (const auto& row : rows) {
+        const double expected =
+            equity.qty * equity.current_price * row[2] +
+            call.qty * (risk::bs::price(true, 100.0 * (1.0 + row[0]), 95.0, 0.03, 0.3, 0.75) - call.current_price) +
+            put.qty * (risk::bs::price(false, 50.0 * (1.0 + row[1]), 55.0, 0.03, 0.3, 0.75) - put.current_price);
+        REQUIRE(prepared.revalue(row.data()) == Approx(expected).margin(1e-10));
+    }
+}
+
+TEST_CASE("PreparedPortfolio validates factor indices up front") {
+    const auto soa = risk::to_struct_of_arrays({fixtures::make_option(true, 4, 100.0, 100.0, 1.0)});
+    REQUIRE_THROWS_AS(risk::PreparedPortfolio(soa, 4), std::out_of_range);
+    REQUIRE_NOTHROW(risk::PreparedPortfolio(soa, 5));
+
+    const risk::PreparedPortfolio prepared(soa, 5);
+    REQUIRE_THROWS_AS(prepared.revalue(nullptr), std::invalid_argument);
+}
+
+TEST_CASE("PreparedPortfolio collapses equity lines into per-factor exposure") {
+    std::vector<risk::Instrument> book;
+    for (std::uint32_t i = 0; i < 10; ++i) {
+        book.push_back(fixtures::make_equity(i % 3, 10.0, static_cast<double>(i + 1)));
+    }
+    book.push_back(fixtures::make_option(false, 1, 100.0, 105.0, 2.0));
+    const auto soa = risk::to_struct_of_arrays(book);
+
+    const risk::PreparedPortfolio prepared(soa, 4);
+    REQUIRE(prepared.equity_count() == 10);
+    REQUIRE(prepared.equity_exposure().size() == 4);
+    REQUIRE(prepared.equity_exposure()[0] == Approx(10.0 * (1 + 4 + 7 + 10)));
+    REQUIRE(prepared.equity_exposure()[1] == Approx(10.0 * (2 + 5 + 8)));
+    REQUIRE(prepared.equity_exposure()[2] == Approx(10.0 * (3 + 6 + 9)));
+    REQUIRE(prepared.equity_exposure()[3] == 0.0);
+
+    const std::vector<double> shocks{0.01, -0.02, 0.03, 0.5,
+                                     -0.04, 0.05, 0.0, -0.5,
+                                     0.0, 0.0, 0.0, 0.0};
+    std::vector<double> equity_pnl(3, 0.0);
+    prepared.equity_pnl(shocks, 3, equity_pnl);
+
+    for (std::size_t t = 0; t < 3; ++t) {
+        const double* row = shocks.data() + t * 4;
+        double expected = 0.0;
+        for (std::size_t i = 0; i < 10; ++i) {
+            expected += soa.current_price[i] * soa.qty[i] * row[soa.id[i]];
+        }
+        REQUIRE(equity_pnl[t] == Approx(expected).margin(1e-12));
+        REQUIRE(prepared.revalue(row) == equity_pnl[t] + prepared.option_pnl(row));
+    }
+}
+
+
+TEST_CASE("PreparedPortfolio option kernel stays within its documented tolerance of bs::price") {
+    // Spans several kernel blocks with a ragged tail, both payoffs, and
+    // degenerate vols, maturities and strikes; one factor per contract.
+    std::vector<risk::Instrument> book;
+    for (int i = 0; i < 601; ++i) {
+        risk::Instrument option{};
+        option.id = static_cast<std::uint32_t>(i);
+        option.type = risk::InstrumentType::Option;
+        option.is_call = i % 2 == 0;
+        option.qty = i % 3 == 0 ? -2.0 : 1.0;
+        option.underlying_price = 40.0 + 0.25 * static_cast<double>(i);
+        option.underlying_index = option.id;
+        option.strike = i == 4 ? 0.0 : 100.0 + static_cast<double>(i % 7) * 5.0;
+        option.rate = 0.01 * static_cast<double>(i % 5);
+        option.implied_vol = i % 11 == 0 ? 0.0 : 0.05 + 0.01 * static_cast<double>(i % 40);
+        option.time_to_maturity = i % 13 == 0 ? 0.0 : 0.02 * static_cast<double>(1 + i % 60);
+        option.current_price = risk::bs::price(option.is_call,
+                                               option.underlying_price,
+                                               option.strike,
+                                               option.rate,
+                                               option.implied_vol,
+                                               option.time_to_maturity);
+        book.push_back(option);
+    }
+    const auto soa = risk::to_struct_of_arrays(book);
+    const risk::PreparedPortfolio prepared(soa, book.size());
+
+    std::vector<double> row(book.size());
+    for (std::size_t i = 0; i < row.size(); ++i) {
+        row[i] = 0.3 * std::sin(static_cast<double>(i));
+    }
+    row[3] = -1.2; // shocked spot below zero prices at zero
+
+    for (const auto mode : {risk::vmath::MathMode::Exact, risk::vmath::MathMode::Fast}) {
+        const double tolerance =
+            mode == risk::vmath::MathMode::Exact ? risk::kRevalueTolerance : risk::kFastRevalueTolerance;
+        risk::vmath::set_math_mode(mode);
+
+        double expected = 0.0;
+        double margin = 0.0;
+        double worst_ratio = 0.0;
+        for (std::size_t i = 0; i < book.size(); ++i) {
+            const risk::Instrument& option = book[i];
+            const double shocked = option.underlying_price * (1.0 + row[i]);
+            const double reference = risk::bs::price(
+                option.is_call, shocked, option.strike, option.rate, option.implied_vol, option.time_to_maturity);
+            expected += option.qty * (reference - option.current_price);
+            margin += std::abs(option.qty) * tolerance * (std::max(shocked, 0.0) + option.strike);
+
+            // The contract alone, so its error is not hidden by the others.
+            const auto single = risk::to_struct_of_arrays({option});
+            const risk::PreparedPortfolio alone(single, book.size());
+            const double price = alone.option_pnl(row.data()) / option.qty + option.current_price;
+            const double scale = std::max(shocked, 0.0) + option.strike;
+            worst_ratio = std::max(worst_ratio, std::abs(price - reference) / (tolerance * scale));
+        }
+        REQUIRE(worst_ratio <= 1.0);
+        REQUIRE(prepared.option_pnl(row.data()) == Approx(expected).margin(margin));
+    }
+    risk::vmath::set_math_mode(risk::vmath::MathMode::Exact);
+}
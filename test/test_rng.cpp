@@ -0,0 +1,61 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <cmath>
+#include <vector>
+
+#include <risk/rng.hpp>
+
+using Catch::Approx;
+
+TEST_CASE("philox4x32 reproduces the Random123 known-answer vectors") {
+    using risk::rng::PhiloxCounter;
+    REQUIRE(risk::rng::philox4x32({0, 0, 0, 0}, {0, 0}) ==
+            PhiloxCounter{0x6627e8d5, 0xe169c58d, 0xbc57ac4c, 0x9b00dbd8});
+    REQUIRE(risk::rng::philox4x32({0xffffffff, 0xffffffff, 0xffffffff, 0xffffffff}, {0xffffffff, 0xffffffff}) ==
+            PhiloxCounter{0x408f276d, 0x41c83b0e, 0xa20bc7c6, 0x6d5451fd});
+    REQUIRE(risk::rng::philox4x32({0x243f6a88, 0x85a308d3, 0x13198a2e, 0x03707344}, {0xa4093822, 0x299f31d0}) ==
+            PhiloxCounter{0xd16cfe09, 0x94fdcceb, 0x5001e420, 0x24126ea1});
+}
+
+TEST_CASE("path_normals is a pure function of seed, path and index") {
+    std::vector<double> a(7);
+    std::vector<double> b(7);
+    risk::rng::path_normals(42, 123456789012ULL, a);
+    risk::rng::path_normals(42, 123456789012ULL, b);
+    REQUIRE(a == b);
+
+    // A shorter request is a prefix of a longer one.
+    std::vector<double> prefix(4);
+    risk::rng::path_normals(42, 123456789012ULL, prefix);
+    for (std::size_t i = 0; i < prefix.size(); ++i) {
+        REQUIRE(prefix[i] == a[i]);
+    }
+
+    risk::rng::path_normals(43, 123456789012ULL, b);
+    REQUIRE(a != b);
+
+    REQUIRE(risk::rng::to_unit_open(0) > 0.0);
+    REQUIRE(risk::rng::to_unit_open(~0ULL) < 1.0);
+}
+
+TEST_CASE("path_normals draws standard normals") {
+    constexpr std::size_t paths = 20000;
+    constexpr std::size_t dim = 5;
+    std::vector<double> z(dim);
+    double sum = 0.0;
+    double sum_sq = 0.0;
+    double cross = 0.0;
+    for (std::size_t p = 0; p < paths; ++p) {
+        risk::rng::path_normals(7, p, z);
+        for (double v : z) {
+            sum += v;
+            sum_sq += v * v;
+        }
+        cross += z[0] * z[1];
+    }
+    const double n = static_cast<double>(paths * dim);
+    REQUIRE(sum / n == Approx(0.0).margin(0.02));
+    REQUIRE(sum_sq / n == Approx(1.0).margin(0.02));
+    REQUIRE(cross / static_cast<double>(paths) == Approx(0.0).margin(0.03));
+}
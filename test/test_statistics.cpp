@@ -0,0 +1,294 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <risk/eigen_stub.hpp>
+#include <risk/factor_cache.hpp>
+#include <risk/linalg.hpp>
+#include <risk/statistics.hpp>
+
+using Catch::Approx;
+
+namespace {
+
+std::vector<double> make_shocks(std::size_t scenarios, std::size_t factors) {
+    std::vector<double> shocks(scenarios * factors);
+    for (std::size_t t = 0; t < scenarios; ++t) {
+        const double market = 0.01 * (static_cast<double>((t * 37) % 29) / 14.0 - 1.0);
+        for (std::size_t i = 0; i < factors; ++i) {
+            std::uint64_t h = (t * factors + i + 1) * 0x9E3779B97F4A7C15ULL;
+            h ^= h >> 31U;
+            h *= 0xBF58476D1CE4E5B9ULL;
+            h ^= h >> 29U;
+            const double noise = static_cast<double>(h >> 11U) * 0x1.0p-53 - 0.5;
+            shocks[t * factors + i] = 0.0005 * static_cast<double>(i % 7) + market * (1.0 + 0.1 * i) + 0.02 * noise;
+        }
+    }
+    return shocks;
+}
+
+// The textbook two-pass loop the blocked kernel replaces.
+std::vector<double> naive_covariance(const std::vector<double>& shocks,
+                                     const Eigen::VectorXd& mean,
+                                     std::size_t scenarios,
+                                     std::size_t factors) {
+    std::vector<double> cov(factors * factors, 0.0);
+    for (std::size_t t = 0; t < scenarios; ++t) {
+        for (std::size_t i = 0; i < factors; ++i) {
+            const double di = shocks[t * factors + i] - mean(static_cast<Eigen::Index>(i));
+            for (std::size_t j = 0; j < factors; ++j) {
+                cov[i * factors + j] += di * (shocks[t * factors + j] - mean(static_cast<Eigen::Index>(j)));
+            }
+        }
+    }
+    for (double& v : cov) {
+        v /= static_cast<double>(scenarios - 1);
+    }
+    return cov;
+}
+
+} // namespace
+
+TEST_CASE("compute_sample_covariance matches the naive sum, symmetric and thread-independent") {
+    // Dimensions off every block size of the kernel.
+    const std::size_t scenarios = 301;
+    const std::size_t factors = 147;
+    const std::vector<double> shocks = make_shocks(scenarios, factors);
+
+    const Eigen::VectorXd mean = risk::compute_sample_mean(shocks, scenarios, factors);
+    bool means_exact = true;
+    for (std::size_t i = 0; i < factors; ++i) {
+        double sum = 0.0;
+        for (std::size_t t = 0; t < scenarios; ++t) {
+            sum += shocks[t * factors + i];
+        }
+        means_exact = means_exact && mean(static_cast<Eigen::Index>(i)) == sum * (1.0 / static_cast<double>(scenarios));
+    }
+    REQUIRE(means_exact);
+
+    const Eigen::MatrixXd cov = risk::compute_sample_covariance(shocks, mean, scenarios, factors);
+    const std::vector<double> expected = naive_covariance(shocks, mean, scenarios, factors);
+    double worst = 0.0;
+    bool symmetric = true;
+    for (std::size_t i = 0; i < factors; ++i) {
+        for (std::size_t j = 0; j < factors; ++j) {
+            const auto r = static_cast<Eigen::Index>(i);
+            const auto c = static_cast<Eigen::Index>(j);
+            worst = std::max(worst, std::abs(cov(r, c) - expected[i * factors + j]));
+            symmetric = symmetric && cov(r, c) == cov(c, r);
+        }
+    }
+    REQUIRE(worst < 1e-15);
+    REQUIRE(symmetric);
+
+    const Eigen::VectorXd mean4 = risk::compute_sample_mean(shocks, scenarios, factors, 4);
+    const Eigen::MatrixXd cov4 = risk::compute_sample_covariance(shocks, mean4, scenarios, factors, 4);
+    bool identical = true;
+    for (std::size_t i = 0; i < factors; ++i) {
+        identical = identical && mean4(static_cast<Eigen::Index>(i)) == mean(static_cast<Eigen::Index>(i));
+        for (std::size_t j = 0; j < factors; ++j) {
+            const auto r = static_cast<Eigen::Index>(i);
+            const auto c = static_cast<Eigen::Index>(j);
+            identical = identical && cov4(r, c) == cov(r, c);
+        }
+    }
+    REQUIRE(identical);
+
+    const Eigen::MatrixXd single = risk::compute_sample_covariance(std::span<const double>(shocks).first(factors),
+                                                                   mean,
+                                                                   1,
+                                                                   factors);
+    REQUIRE(single(3, 5) == 0.0);
+
+    REQUIRE_THROWS_AS(risk::compute_sample_mean(shocks, 0, factors), std::invalid_argument);
+    REQUIRE_THROWS_AS(risk::compute_sample_mean(shocks, scenarios, factors + 1), std::invalid_argument);
+    REQUIRE_THROWS_AS(risk::compute_sample_covariance(shocks, mean, scenarios - 1, factors), std::invalid_argument);
+    REQUIRE_THROWS_AS(risk::compute_sample_covariance(shocks, Eigen::VectorXd::Zero(3), scenarios, factors),
+                      std::invalid_argument);
+}
+
+// Not run by default: `risk_tests "[benchmark]"` times the blocked covariance
+// against the naive loop on a long history.
+TEST_CASE("compute_sample_covariance timing against the naive loop", "[.][benchmark]") {
+    using Clock = std::chrono::steady_clock;
+    const std::size_t scenarios = 2500;
+    std::printf("%8s %8s %12s %12s %12s\n", "days", "tickers", "naive s", "blocked s", "all cores s");
+    for (std::size_t factors : {250U, 500U, 1000U}) {
+        const std::vector<double> shocks = make_shocks(scenarios, factors);
+        const Eigen::VectorXd mean = risk::compute_sample_mean(shocks, scenarios, factors);
+
+        auto start = Clock::now();
+        const std::vector<double> naive = naive_covariance(shocks, mean, scenarios, factors);
+        const double naive_s = std::chrono::duration<double>(Clock::now() - start).count();
+
+        start = Clock::now();
+        const Eigen::MatrixXd blocked = risk::compute_sample_covariance(shocks, mean, scenarios, factors);
+        const double blocked_s = std::chrono::duration<double>(Clock::now() - start).count();
+
+        start = Clock::now();
+        const Eigen::MatrixXd parallel = risk::compute_sample_covariance(shocks, mean, scenarios, factors, 0);
+        const double parallel_s = std::chrono::duration<double>(Clock::now() - start).count();
+
+        std::printf("%8zu %8zu %12.4f %12.4f %12.4f\n", scenarios, factors, naive_s, blocked_s, parallel_s);
+        REQUIRE(blocked(1, 2) == Approx(naive[factors + 2]));
+        REQUIRE(parallel(1, 2) == blocked(1, 2));
+    }
+}
+
+TEST_CASE("RollingMoments slides a window and keeps its Cholesky factor current") {
+    const std::size_t factors = 23;
+    const std::size_t window = 60;
+    const std::size_t scenarios = 140;
+    const std::vector<double> shocks = make_shocks(scenarios, factors);
+    const auto row = [&](std::size_t t) { return std::span<const double>(shocks).subspan(t * factors, factors); };
+
+    // The CSV seeding: the first window of rows, then slide to the last one.
+    risk::RollingMoments rolling(std::span<const double>(shocks).first(window * factors), window, factors);
+    REQUIRE(rolling.factorize());
+    for (std::size_t t = window; t < scenarios; ++t) {
+        rolling.push(row(t));
+        rolling.pop(row(t - window));
+    }
+    REQUIRE(rolling.count() == window);
+    REQUIRE(rolling.has_factor());
+
+    const std::span<const double> last = std::span<const double>(shocks).last(window * factors);
+    const Eigen::VectorXd mean = risk::compute_sample_mean(last, window, factors);
+    const Eigen::MatrixXd cov = risk::compute_sample_covariance(last, mean, window, factors);
+    const Eigen::VectorXd rolled_mean = rolling.mean_vector();
+    const Eigen::MatrixXd rolled_cov = rolling.covariance();
+    double worst_mean = 0.0;
+    double worst_cov = 0.0;
+    double scale = 0.0;
+    for (Eigen::Index i = 0; i < static_cast<Eigen::Index>(factors); ++i) {
+        worst_mean = std::max(worst_mean, std::abs(rolled_mean(i) - mean(i)));
+        scale = std::max(scale, cov(i, i));
+        for (Eigen::Index j = 0; j < static_cast<Eigen::Index>(factors); ++j) {
+            worst_cov = std::max(worst_cov, std::abs(rolled_cov(i, j) - cov(i, j)));
+        }
+    }
+    REQUIRE(worst_mean < 1e-15);
+    REQUIRE(worst_cov < 1e-12 * scale);
+
+    // The updated factor reproduces the window's covariance.
+    const risk::linalg::Matrix l = rolling.covariance_factor();
+    risk::linalg::Matrix llt(factors, factors);
+    risk::linalg::gemm(l, l.transposed(), llt);
+    double worst_factor = 0.0;
+    for (std::size_t i = 0; i < factors; ++i) {
+        for (std::size_t j = 0; j < factors; ++j) {
+            worst_factor = std::max(worst_factor,
+                                    std::abs(llt(i, j) - cov(static_cast<Eigen::Index>(i), static_cast<Eigen::Index>(j))));
+        }
+    }
+    REQUIRE(worst_factor < 1e-12 * scale);
+
+    // The KDB+ seeding, from moments alone, rolls the same way.
+    risk::RollingMoments from_moments(mean, cov, window);
+    from_moments.push(row(0));
+    rolling.push(row(0));
+    REQUIRE(from_moments.covariance()(4, 7) == Approx(rolling.covariance()(4, 7)).epsilon(1e-12));
+
+    // Shrinking to fewer rows than factors drops the factor.
+    for (std::size_t t = scenarios - window; rolling.count() > factors; ++t) {
+        rolling.pop(row(t));
+    }
+    REQUIRE_FALSE(rolling.has_factor());
+    REQUIRE_THROWS_AS(rolling.covariance_factor(), std::logic_error);
+    REQUIRE_FALSE(rolling.factorize());
+    REQUIRE_THROWS_AS(rolling.push(std::span<const double>(shocks).first(factors - 1)), std::invalid_argument);
+}
+
+TEST_CASE("EwmaCovariance weights days geometrically and resumes from checkpoints") {
+    const std::size_t factors = 9;
+    const std::size_t scenarios = 120;
+    const double decay = 0.94;
+    const std::vector<double> shocks = make_shocks(scenarios, factors);
+
+    // Finch's recursion is the weighted mean and covariance with weight
+    // decay^(T-1) on the first day and (1 - decay) decay^(T-1-t) on day t > 0.
+    const risk::EwmaCovariance ewma = risk::ewma_covariance(shocks, scenarios, factors, decay);
+    REQUIRE(ewma.days() == scenarios);
+    std::vector<double> weights(scenarios);
+    for (std::size_t t = 0; t < scenarios; ++t) {
+        const double age = std::pow(decay, static_cast<double>(scenarios - 1 - t));
+        weights[t] = t == 0 ? age : (1.0 - decay) * age;
+    }
+    const Eigen::VectorXd mean = ewma.mean();
+    const Eigen::MatrixXd cov = ewma.covariance();
+    double worst = 0.0;
+    for (std::size_t i = 0; i < factors; ++i) {
+        double m = 0.0;
+        for (std::size_t t = 0; t < scenarios; ++t) {
+            m += weights[t] * shocks[t * factors + i];
+        }
+        worst = std::max(worst, std::abs(m - mean(static_cast<Eigen::Index>(i))));
+    }
+    REQUIRE(worst < 1e-15);
+    double worst_cov = 0.0;
+    for (std::size_t i = 0; i < factors; ++i) {
+        for (std::size_t j = 0; j < factors; ++j) {
+            double c = 0.0;
+            for (std::size_t t = 0; t < scenarios; ++t) {
+                c += weights[t] * (shocks[t * factors + i] - mean(static_cast<Eigen::Index>(i))) *
+                     (shocks[t * factors + j] - mean(static_cast<Eigen::Index>(j)));
+            }
+            worst_cov = std::max(worst_cov, std::abs(cov(static_cast<Eigen::Index>(i), static_cast<Eigen::Index>(j)) - c));
+        }
+    }
+    REQUIRE(worst_cov < 1e-12 * cov(0, 0));
+
+    const std::filesystem::path directory =
+        std::filesystem::temp_directory_path() / ("risk_ewma_test_" + std::to_string(::getpid()));
+    std::filesystem::remove_all(directory);
+    const risk::FactorCache cache(directory.string());
+
+    // Yesterday's run checkpoints; today's, one week longer, streams the week.
+    std::size_t replayed = 0;
+    (void)risk::ewma_covariance(std::span<const double>(shocks).first((scenarios - 7) * factors),
+                                scenarios - 7,
+                                factors,
+                                decay,
+                                &cache,
+                                64,
+                                &replayed);
+    REQUIRE(replayed == scenarios - 7);
+    const risk::EwmaCovariance resumed = risk::ewma_covariance(shocks, scenarios, factors, decay, &cache, 64, &replayed);
+    REQUIRE(replayed == 7);
+    const Eigen::MatrixXd resumed_cov = resumed.covariance();
+    bool identical = true;
+    for (Eigen::Index i = 0; i < static_cast<Eigen::Index>(factors); ++i) {
+        identical = identical && resumed.mean()(i) == mean(i);
+        for (Eigen::Index j = 0; j < static_cast<Eigen::Index>(factors); ++j) {
+            identical = identical && resumed_cov(i, j) == cov(i, j);
+        }
+    }
+    REQUIRE(identical);
+
+    // Another decay, or a revised day in the history, starts from scratch.
+    (void)risk::ewma_covariance(shocks, scenarios, factors, 0.97, &cache, 64, &replayed);
+    REQUIRE(replayed == scenarios);
+    std::vector<double> revised = shocks;
+    revised[3 * factors + 2] += 1e-6;
+    (void)risk::ewma_covariance(revised, scenarios, factors, decay, &cache, 64, &replayed);
+    REQUIRE(replayed == scenarios);
+    (void)risk::ewma_covariance(shocks, scenarios, factors, decay, &cache, 64, &replayed);
+    REQUIRE(replayed == 0);
+    std::filesystem::remove_all(directory);
+
+    REQUIRE_THROWS_AS(risk::EwmaCovariance(factors, 1.0), std::invalid_argument);
+    REQUIRE_THROWS_AS(risk::EwmaCovariance(0, decay), std::invalid_argument);
+    REQUIRE_THROWS_AS(risk::ewma_covariance(shocks, scenarios + 1, factors, decay), std::invalid_argument);
+}
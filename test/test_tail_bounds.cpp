@@ -0,0 +1,79 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <vector>
+
+#include <risk/hvar.hpp>
+#include <risk/instrument.hpp>
+#include <risk/instrument_soa.hpp>
+#include <risk/prepared_portfolio.hpp>
+#include <risk/pricing_grid.hpp>
+#include <risk/tail_bounds.hpp>
+#include <risk/universe.hpp>
+#include <risk/vmath.hpp>
+
+#include "fixtures.hpp"
+
+namespace {
+
+risk::InstrumentSoA make_book() {
+    std::vector<risk::Instrument> lines;
+    for (int i = 0; i < 24; ++i) {
+        const std::uint32_t underlying = static_cast<std::uint32_t>(i % 3);
+        const double spot = 50.0 + 25.0 * underlying;
+        const double strike = spot * (0.8 + 0.02 * i);
+        const fixtures::OptionTerms terms{0.03, 0.3, 0.05 + 0.04 * i};
+        lines.push_back(fixtures::make_option(i % 2 == 0, underlying, spot, strike, (i % 5) - 2.0, terms));
+    }
+    lines.push_back(fixtures::make_equity(3, 20.0, -50.0));
+    return risk::to_struct_of_arrays(lines);
+}
+
+// Scenario 7 wipes out the first underlying (shock below -1).
+std::vector<double> make_shocks(std::size_t rows, std::size_t cols) {
+    std::vector<double> shocks = fixtures::make_shocks(rows, cols, 0.08);
+    shocks[7 * cols] = -1.2;
+    return shocks;
+}
+
+} // namespace
+
+TEST_CASE("PnlBounds bracket the full option P&L of every scenario") {
+    const auto soa = make_book();
+    const risk::PreparedPortfolio prepared(soa, 4);
+    const std::vector<double> shocks = make_shocks(400, 4);
+    const auto ranges = risk::shock_ranges(shocks, 400, 4);
+    const risk::PnlBounds bounds(prepared, ranges, 16);
+
+    for (std::size_t t = 0; t < 400; ++t) {
+        const double* row = shocks.data() + t * 4;
+        double lower = 0.0;
+        double upper = 0.0;
+        bounds.option_bounds(row, lower, upper);
+        const double pnl = prepared.option_pnl(row);
+        REQUIRE(lower <= pnl);
+        REQUIRE(pnl <= upper);
+    }
+}
+
+TEST_CASE("tail-pruned HVaR is bit-identical to full revaluation") {
+    risk::set_universe({"SPY", "QQQ", "XOM", "TSLA"});
+    const auto soa = make_book();
+    const std::size_t rows = 1500;
+    const std::vector<double> shocks = make_shocks(rows, 4);
+
+    risk::RevaluationOptions options;
+    options.prune_tail = true;
+    for (const risk::vmath::MathMode mode : {risk::vmath::MathMode::Exact, risk::vmath::MathMode::Fast}) {
+        risk::vmath::set_math_mode(mode);
+        for (const double alpha : {0.9, 0.99, 0.999}) {
+            const auto full = risk::compute_hvar(soa, shocks, rows, 4, alpha);
+            risk::RevaluationStats stats;
+            const auto pruned = risk::compute_hvar(soa, shocks, rows, 4, alpha, options, &stats);
+            REQUIRE(pruned.var == full.var);
+            REQUIRE(pruned.cvar == full.cvar);
+            REQUIRE(stats.pruned_rows > rows / 2);
+        }
+    }
+    risk::vmath::set_math_mode(risk::vmath::MathMode::Exact);
+}
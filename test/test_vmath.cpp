@@ -0,0 +1,123 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/catch_approx.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <vector>
+
+#include <risk/vmath.hpp>
+
+using Catch::Approx;
+
+namespace {
+
+class ScopedMathMode {
+public:
+    explicit ScopedMathMode(risk::vmath::MathMode mode)
+        : previous_(risk::vmath::math_mode()) {
+        risk::vmath::set_math_mode(mode);
+    }
+    ~ScopedMathMode() {
+        risk::vmath::set_math_mode(previous_);
+    }
+
+private:
+    risk::vmath::MathMode previous_;
+};
+
+double reference_cdf(double x) {
+    return 0.5 * std::erfc(-x / std::sqrt(2.0));
+}
+
+} // namespace
+
+TEST_CASE("fast_exp stays within its documented relative error") {
+    double worst = 0.0;
+    for (double x = -708.0; x <= 709.0; x += 0.0137) {
+        const double expected = std::exp(x);
+        worst = std::max(worst, std::abs(risk::vmath::fast_exp(x) - expected) / expected);
+    }
+    REQUIRE(worst <= risk::vmath::kFastExpMaxRelError);
+    REQUIRE(risk::vmath::fast_exp(0.0) == 1.0);
+}
+
+TEST_CASE("fast_expm1 stays within its documented relative error") {
+    double worst = 0.0;
+    for (double x = -708.0; x <= 709.0; x += 0.0137) {
+        const double expected = std::expm1(x);
+        worst = std::max(worst, std::abs(risk::vmath::fast_expm1(x) - expected) / std::abs(expected));
+    }
+    // Small arguments, where e^x - 1 would cancel.
+    for (double x = -0.4; x <= 0.4; x += 1.0e-5) {
+        if (x != 0.0) {
+            const double expected = std::expm1(x);
+            worst = std::max(worst, std::abs(risk::vmath::fast_expm1(x) - expected) / std::abs(expected));
+        }
+    }
+    REQUIRE(worst <= risk::vmath::kFastExpm1MaxRelError);
+    REQUIRE(risk::vmath::fast_expm1(0.0) == 0.0);
+    REQUIRE(risk::vmath::fast_expm1(1e-300) == 1e-300);
+}
+
+TEST_CASE("fast_log stays within its documented error") {
+    double worst = 0.0;
+    for (double lx = -700.0; lx <= 700.0; lx += 0.0071) {
+        const double x = std::exp(lx);
+        const double expected = std::log(x);
+        worst = std::max(worst, std::abs(risk::vmath::fast_log(x) - expected) / std::max(1.0, std::abs(expected)));
+    }
+    REQUIRE(worst <= risk::vmath::kFastLogMaxAbsError);
+    REQUIRE(risk::vmath::fast_log(1.0) == 0.0);
+}
+
+TEST_CASE("fast_normal_cdf stays within its documented absolute and tail errors") {
+    double worst_abs = 0.0;
+    double worst_rel = 0.0;
+    for (double x = -40.0; x <= 40.0; x += 0.00173) {
+        const double expected = reference_cdf(x);
+        const double got = risk::vmath::fast_normal_cdf(x);
+        worst_abs = std::max(worst_abs, std::abs(got - expected));
+        if (x >= -37.0) {
+            worst_rel = std::max(worst_rel, std::abs(got - expected) / expected);
+        }
+    }
+    REQUIRE(worst_abs <= risk::vmath::kFastNormalCdfMaxAbsError);
+    REQUIRE(worst_rel <= risk::vmath::kFastNormalCdfMaxRelError);
+    REQUIRE(risk::vmath::fast_normal_cdf(0.0) == Approx(0.5).margin(1e-16));
+}
+
+TEST_CASE("vmath span kernels dispatch on the runtime math mode") {
+    std::vector<double> x;
+    for (int i = -50; i <= 50; ++i) {
+        x.push_back(0.1 * static_cast<double>(i));
+    }
+    std::vector<double> exact(x.size());
+    std::vector<double> fast(x.size());
+
+    {
+        ScopedMathMode mode(risk::vmath::MathMode::Exact);
+        risk::vmath::normal_cdf(x, exact);
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            REQUIRE(exact[i] == reference_cdf(x[i]));
+        }
+    }
+    {
+        ScopedMathMode mode(risk::vmath::MathMode::Fast);
+        REQUIRE(risk::vmath::math_mode() == risk::vmath::MathMode::Fast);
+        risk::vmath::normal_cdf(x, fast);
+    }
+    REQUIRE(risk::vmath::math_mode() == risk::vmath::MathMode::Exact);
+
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        REQUIRE(fast[i] == Approx(exact[i]).margin(risk::vmath::kFastNormalCdfMaxAbsError));
+    }
+
+    // In-place evaluation is allowed.
+    std::vector<double> in_place = x;
+    risk::vmath::normal_pdf(in_place, in_place);
+    REQUIRE(in_place[50] == Approx(0.3989422804014327).epsilon(1e-15));
+
+    std::vector<double> short_out(x.size() - 1);
+    REQUIRE_THROWS_AS(risk::vmath::exp(x, short_out), std::invalid_argument);
+}